@@ -0,0 +1,150 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the cost of writing into outbuffs that are in "bad" state
+// ( truncated C strings, discarded content ) in many threads at once.
+// The "shared" variants reproduce a garbage buffer that is a single
+// static array for all threads, as strf::outbuff_garbage_buf used to be,
+// while the "thread_local" ones use strf::outbuff_garbage_buf, which is
+// now a different buffer in each thread.
+
+#include <strf/to_cfile.hpp>
+#include <benchmark/benchmark.h>
+#include <thread>
+
+#define STR2(...) #__VA_ARGS__
+#define STR(...) STR2(__VA_ARGS__)
+
+template <typename CharT>
+inline CharT* shared_garbage_buf() noexcept
+{
+    static CharT arr[ STRF_MIN_SPACE_AFTER_RECYCLE ];
+    return arr;
+}
+
+template <typename CharT>
+inline CharT* shared_garbage_buf_end() noexcept
+{
+    return shared_garbage_buf<CharT>() + strf::min_space_after_recycle<CharT>();
+}
+
+class shared_garbage_cstr_writer final: public strf::basic_outbuff_noexcept<char>
+{
+public:
+
+    shared_garbage_cstr_writer(char* dest, std::size_t len) noexcept
+        : strf::basic_outbuff_noexcept<char>(dest, dest + len - 1)
+    {
+    }
+
+    void recycle() noexcept override
+    {
+        if (this->good()) {
+            it_ = this->pointer();
+            this->set_good(false);
+        }
+        this->set_pointer(shared_garbage_buf<char>());
+        this->set_end(shared_garbage_buf_end<char>());
+    }
+
+    char* finish() noexcept
+    {
+        if (this->good()) {
+            it_ = this->pointer();
+            this->set_good(false);
+        }
+        this->set_pointer(shared_garbage_buf<char>());
+        this->set_end(shared_garbage_buf_end<char>());
+        *it_ = '\0';
+        return it_;
+    }
+
+private:
+
+    char* it_ = nullptr;
+};
+
+class shared_garbage_discarded_outbuff final: public strf::basic_outbuff_noexcept<char>
+{
+public:
+
+    shared_garbage_discarded_outbuff() noexcept
+        : strf::basic_outbuff_noexcept<char>
+            { shared_garbage_buf<char>(), shared_garbage_buf_end<char>() }
+    {
+        this->set_good(false);
+    }
+
+    void recycle() noexcept override
+    {
+        this->set_pointer(shared_garbage_buf<char>());
+        this->set_end(shared_garbage_buf_end<char>());
+    }
+};
+
+#define SAMPLE_ARGS                                                     \
+    "blah blah blah blah blah ", 123456789, " blah ", strf::hex(0xabcdef), \
+    strf::right("blah", 100, '.'), 1234567890123ll, " blah blah blah"
+
+static void shared_garbage_truncated_cstr(benchmark::State& state)
+{
+    char dest[16];
+    for(auto _ : state) {
+        shared_garbage_cstr_writer ob(dest, sizeof(dest));
+        strf::to(ob) (SAMPLE_ARGS);
+        ob.finish();
+        benchmark::DoNotOptimize(dest);
+        benchmark::ClobberMemory();
+    }
+}
+
+static void thread_local_garbage_truncated_cstr(benchmark::State& state)
+{
+    char dest[16];
+    for(auto _ : state) {
+        strf::to(dest) (SAMPLE_ARGS);
+        benchmark::DoNotOptimize(dest);
+        benchmark::ClobberMemory();
+    }
+}
+
+static void shared_garbage_discarded(benchmark::State& state)
+{
+    for(auto _ : state) {
+        shared_garbage_discarded_outbuff ob;
+        strf::to(ob) (SAMPLE_ARGS);
+        benchmark::ClobberMemory();
+    }
+}
+
+static void thread_local_garbage_discarded(benchmark::State& state)
+{
+    for(auto _ : state) {
+        strf::discarded_outbuff<char> ob;
+        strf::to(ob) (SAMPLE_ARGS);
+        benchmark::ClobberMemory();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int max_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    benchmark::RegisterBenchmark("shared_garbage_truncated_cstr", shared_garbage_truncated_cstr)
+        ->ThreadRange(1, max_threads)->UseRealTime();
+    benchmark::RegisterBenchmark("thread_local_garbage_truncated_cstr", thread_local_garbage_truncated_cstr)
+        ->ThreadRange(1, max_threads)->UseRealTime();
+    benchmark::RegisterBenchmark("shared_garbage_discarded", shared_garbage_discarded)
+        ->ThreadRange(1, max_threads)->UseRealTime();
+    benchmark::RegisterBenchmark("thread_local_garbage_discarded", thread_local_garbage_discarded)
+        ->ThreadRange(1, max_threads)->UseRealTime();
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    strf::to(stdout) ("\n    SAMPLE_ARGS = " STR(SAMPLE_ARGS) "\n");
+
+    return 0;
+}
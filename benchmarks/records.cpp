@@ -0,0 +1,71 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/records.hpp>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+struct row
+{
+    const char* name;
+    int id;
+    double value;
+};
+
+static std::vector<row> make_rows()
+{
+    std::vector<row> rows;
+    for (int i = 0; i < 100; ++i) {
+        rows.push_back({"abcdef", i * 37, i * 1.25});
+    }
+    return rows;
+}
+
+#define CREATE_BENCHMARK(PREFIX)                             \
+    static void PREFIX ## _func (benchmark::State& state) {  \
+        const auto rows = make_rows();                       \
+        static char dest[100 * 64];                          \
+        for(auto _ : state) {                                \
+            strf::cstr_writer ob(dest);                      \
+            PREFIX ## _OP ;                                  \
+            ob.finish();                                     \
+            benchmark::DoNotOptimize(dest);                  \
+            benchmark::ClobberMemory();                      \
+        }                                                    \
+    }
+
+#define REGISTER_BENCHMARK(X) benchmark::RegisterBenchmark(STR(X ## _OP), X ## _func);
+#define STR2(X) #X
+#define STR(X) STR2(X)
+
+#define LOOP_OP          for (const auto& r : rows)                                 \
+                             strf::to(ob) (r.name, '\t', r.id, '\t', r.value, '\n');
+#define RECORDS_OP       strf::to(ob) (strf::records(rows, [](const row& r) {       \
+                             return std::make_tuple                                 \
+                                 (r.name, '\t', r.id, '\t', r.value, '\n'); }));
+#define FMT_LOOP_OP      for (const auto& r : rows)                                 \
+                             strf::to(ob) ( strf::left(r.name, 8), '\t'             \
+                                          , strf::hex(r.id), '\t'                   \
+                                          , strf::fixed(r.value, 2), '\n' );
+#define FMT_RECORDS_OP   strf::to(ob) (strf::records(rows, [](const row& r) {       \
+                             return std::make_tuple                                 \
+                                 ( strf::left(r.name, 8), '\t', strf::hex(r.id)     \
+                                 , '\t', strf::fixed(r.value, 2), '\n' ); }));
+
+CREATE_BENCHMARK(LOOP);
+CREATE_BENCHMARK(RECORDS);
+CREATE_BENCHMARK(FMT_LOOP);
+CREATE_BENCHMARK(FMT_RECORDS);
+
+int main(int argc, char** argv)
+{
+    REGISTER_BENCHMARK(LOOP);
+    REGISTER_BENCHMARK(RECORDS);
+    REGISTER_BENCHMARK(FMT_LOOP);
+    REGISTER_BENCHMARK(FMT_RECORDS);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
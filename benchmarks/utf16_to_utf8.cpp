@@ -11,6 +11,7 @@
 #include <locale>
 #include <codecvt>
 #include <fstream>
+#include <string>
 #include <benchmark/benchmark.h>
 
 static void fill_with_codepoints
@@ -112,6 +113,32 @@ static void bm_codecvt(benchmark::State& state) {
     }
 }
 
+// Text samples where one code point in every `period` is not ASCII
+static std::u16string make_text_sample(char16_t non_ascii, unsigned period, unsigned count)
+{
+    const char* words = "The quick brown fox jumps over the lazy dog. ";
+    std::u16string str;
+    for (unsigned i = 0, w = 0; i < count; ++i) {
+        if (period != 0 && i % period == period - 1) {
+            str += non_ascii;
+        } else {
+            str += static_cast<char16_t>(words[w]);
+            w = words[w + 1] ? w + 1 : 0;
+        }
+    }
+    return str;
+}
+
+static void bm_text(benchmark::State& state, const std::u16string& u16str)
+{
+    std::string u8dest(u16str.size() * 3 + 1, '\0');
+    for(auto _ : state) {
+        strf::to(&u8dest[0], u8dest.size())(strf::conv(u16str));
+        benchmark::DoNotOptimize(u8dest.data());
+    }
+    state.SetBytesProcessed(state.iterations() * u16str.size() * 2);
+}
+
 static void dummy (benchmark::State&)
 {
 }
@@ -132,6 +159,20 @@ int main(int argc, char** argv)
 
     benchmark::RegisterBenchmark("    -------------", dummy);
 
+    const auto ascii_text  = make_text_sample(u'\u00E9', 0, 1000);
+    const auto mostly_ascii_text = make_text_sample(u'\u00E9', 50, 1000);
+    const auto latin_text  = make_text_sample(u'\u00E7', 5, 1000);
+    const auto cjk_text    = make_text_sample(u'\u6F22', 2, 1000);
+    const auto only_cjk_text = make_text_sample(u'\u6F22', 1, 1000);
+
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::conv(ascii_text))", bm_text, ascii_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::conv(mostly_ascii_text))", bm_text, mostly_ascii_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::conv(latin_text))", bm_text, latin_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::conv(cjk_text))", bm_text, cjk_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::conv(only_cjk_text))", bm_text, only_cjk_text);
+
+    benchmark::RegisterBenchmark("    -------------", dummy);
+
     benchmark::RegisterBenchmark("std::codecvt / u16small1 to utf8", bm_codecvt<20, 1>);
     benchmark::RegisterBenchmark("std::codecvt / u16small2 to utf8", bm_codecvt<20, 2>);
     benchmark::RegisterBenchmark("std::codecvt / u16small3 to utf8", bm_codecvt<20, 3>);
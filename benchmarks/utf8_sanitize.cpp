@@ -0,0 +1,75 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures strf::sani on UTF-8 input that is written as UTF-8
+
+#include <strf/to_string.hpp>
+#include <string>
+#include <benchmark/benchmark.h>
+
+// Text samples where one code point in every `period` is not ASCII
+static std::string make_text_sample(const char* non_ascii, unsigned period, unsigned count)
+{
+    const char* words = "The quick brown fox jumps over the lazy dog. ";
+    std::string str;
+    for (unsigned i = 0, w = 0; i < count; ++i) {
+        if (period != 0 && i % period == period - 1) {
+            str += non_ascii;
+        } else {
+            str += words[w];
+            w = words[w + 1] ? w + 1 : 0;
+        }
+    }
+    return str;
+}
+
+static void bm_sani(benchmark::State& state, const std::string& u8str)
+{
+    std::string u8dest(u8str.size() * 3 + 1, '\0');
+    for(auto _ : state) {
+        strf::to(&u8dest[0], u8dest.size())(strf::sani(u8str));
+        benchmark::DoNotOptimize(u8dest.data());
+    }
+    state.SetBytesProcessed(state.iterations() * u8str.size());
+}
+
+static void bm_sani_to_string(benchmark::State& state, const std::string& u8str)
+{
+    for(auto _ : state) {
+        auto str = strf::to_string(strf::sani(u8str));
+        benchmark::DoNotOptimize(str.data());
+    }
+    state.SetBytesProcessed(state.iterations() * u8str.size());
+}
+
+static void dummy (benchmark::State&)
+{
+}
+
+int main(int argc, char** argv)
+{
+    const auto ascii_text  = make_text_sample("", 0, 1000);
+    const auto mostly_ascii_text = make_text_sample("\xC3\xA9", 50, 1000);
+    const auto latin_text  = make_text_sample("\xC3\xA7", 5, 1000);
+    const auto cjk_text    = make_text_sample("\xE6\xBC\xA2", 2, 1000);
+    const auto emoji_text  = make_text_sample("\xF0\x9F\x98\x80", 10, 1000);
+    const auto invalid_text = make_text_sample("\xC3", 100, 1000);
+
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::sani(ascii_text))", bm_sani, ascii_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::sani(mostly_ascii_text))", bm_sani, mostly_ascii_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::sani(latin_text))", bm_sani, latin_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::sani(cjk_text))", bm_sani, cjk_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::sani(emoji_text))", bm_sani, emoji_text);
+    benchmark::RegisterBenchmark("strf::to(u8dest)(strf::sani(invalid_text))", bm_sani, invalid_text);
+
+    benchmark::RegisterBenchmark("    -------------", dummy);
+
+    benchmark::RegisterBenchmark("strf::to_string(strf::sani(ascii_text))", bm_sani_to_string, ascii_text);
+    benchmark::RegisterBenchmark("strf::to_string(strf::sani(latin_text))", bm_sani_to_string, latin_text);
+    benchmark::RegisterBenchmark("strf::to_string(strf::sani(cjk_text))", bm_sani_to_string, cjk_text);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
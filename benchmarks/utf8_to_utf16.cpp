@@ -11,6 +11,7 @@
 #include <locale>
 #include <fstream>
 #include <codecvt>
+#include <string>
 #include <benchmark/benchmark.h>
 
 #if defined(_MSC_VER)
@@ -124,6 +125,32 @@ static void bm_codecvt(benchmark::State& state) {
     }
 }
 
+// Text samples where one code point in every `period` is not ASCII
+static std::string make_text_sample(const char* non_ascii, unsigned period, unsigned count)
+{
+    const char* words = "The quick brown fox jumps over the lazy dog. ";
+    std::string str;
+    for (unsigned i = 0, w = 0; i < count; ++i) {
+        if (period != 0 && i % period == period - 1) {
+            str += non_ascii;
+        } else {
+            str += words[w];
+            w = words[w + 1] ? w + 1 : 0;
+        }
+    }
+    return str;
+}
+
+static void bm_text(benchmark::State& state, const std::string& u8str)
+{
+    std::u16string u16dest(u8str.size() + 1, u'\0');
+    for(auto _ : state) {
+        strf::to(&u16dest[0], u16dest.size())(strf::conv(u8str));
+        benchmark::DoNotOptimize(u16dest.data());
+    }
+    state.SetBytesProcessed(state.iterations() * u8str.size());
+}
+
 static void dummy (benchmark::State&)
 {
 }
@@ -144,6 +171,20 @@ int main(int argc, char** argv)
 
     benchmark::RegisterBenchmark("    -------------", dummy);
 
+    const auto ascii_text  = make_text_sample("\xC3\xA9", 0, 1000);
+    const auto mostly_ascii_text = make_text_sample("\xC3\xA9", 50, 1000);
+    const auto latin_text  = make_text_sample("\xC3\xA7", 5, 1000);
+    const auto cjk_text    = make_text_sample("\xE6\xBC\xA2", 2, 1000);
+    const auto only_cjk_text = make_text_sample("\xE6\xBC\xA2", 1, 1000);
+
+    benchmark::RegisterBenchmark("strf::to(u16dest)(strf::conv(ascii_text))", bm_text, ascii_text);
+    benchmark::RegisterBenchmark("strf::to(u16dest)(strf::conv(mostly_ascii_text))", bm_text, mostly_ascii_text);
+    benchmark::RegisterBenchmark("strf::to(u16dest)(strf::conv(latin_text))", bm_text, latin_text);
+    benchmark::RegisterBenchmark("strf::to(u16dest)(strf::conv(cjk_text))", bm_text, cjk_text);
+    benchmark::RegisterBenchmark("strf::to(u16dest)(strf::conv(only_cjk_text))", bm_text, only_cjk_text);
+
+    benchmark::RegisterBenchmark("    -------------", dummy);
+
     benchmark::RegisterBenchmark("std::codecvt / u8small1 to utf16", bm_codecvt<20, 1>);
     benchmark::RegisterBenchmark("std::codecvt / u8small2 to utf16", bm_codecvt<20, 2>);
     benchmark::RegisterBenchmark("std::codecvt / u8small3 to utf16", bm_codecvt<20, 3>);
@@ -3,6 +3,8 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <strf/to_cfile.hpp>
+#include <strf/to_string.hpp>
+#include <string>
 #include <benchmark/benchmark.h>
 
 #define CREATE_BENCHMARK(PREFIX)                             \
@@ -100,6 +102,67 @@ const auto custom_calc = strf::make_width_calculator(wfunc);
 #define  CV_C_J50_OP    strf::to(u16dest).with(custom_calc) (strf::join_right(50)(strf::conv(u8str50)));
 
 
+// Text samples of `count` code points where one in every `period` is not ASCII
+template <typename CharT>
+static std::basic_string<CharT> make_text_sample(char32_t non_ascii, unsigned period, unsigned count)
+{
+    const char* words = "The quick brown fox jumps over the lazy dog. ";
+    std::u32string str;
+    for (unsigned i = 0, w = 0; i < count; ++i) {
+        if (period != 0 && i % period == period - 1) {
+            str += non_ascii;
+        } else {
+            str += static_cast<char32_t>(words[w]);
+            w = words[w + 1] ? w + 1 : 0;
+        }
+    }
+    return strf::to_basic_string<CharT>(strf::conv(str));
+}
+
+// The precision makes the width calculator count the code points
+// of almost the whole text
+template <typename WidthCalc, typename CharT>
+static void bm_precision
+    ( benchmark::State& state
+    , WidthCalc wcalc
+    , const std::basic_string<CharT>& str )
+{
+    std::basic_string<CharT> dest(str.size() + 1, CharT('\0'));
+    for(auto _ : state) {
+        strf::to(&dest[0], dest.size()).with(wcalc) (strf::fmt(str).p(990));
+        benchmark::DoNotOptimize(dest.data());
+        benchmark::ClobberMemory();
+    }
+}
+
+template <typename CharT>
+static void register_precision_benchmarks(const char* char_name, const char* dest_name)
+{
+    const struct {
+        const char* name;
+        std::basic_string<CharT> str;
+    } samples[] =
+        { {"ascii_text", make_text_sample<CharT>(0, 0, 1000)}
+        , {"latin_text", make_text_sample<CharT>(U'\u00E7', 5, 1000)}
+        , {"cjk_text",   make_text_sample<CharT>(U'\u6F22', 2, 1000)}
+        , {"emoji_text", make_text_sample<CharT>(U'\U0001F600', 10, 1000)} };
+
+    for (const auto& sample : samples) {
+        const auto fast_name = strf::to_string
+            ("strf::to(", dest_name, ").with(fast_u32len)(strf::fmt("
+            , char_name, sample.name, ").p(990));");
+        const auto robust_name = strf::to_string
+            ("strf::to(", dest_name, ").with(u32len)(strf::fmt("
+            , char_name, sample.name, ").p(990));");
+        benchmark::RegisterBenchmark
+            ( fast_name.c_str(), bm_precision<strf::width_as_fast_u32len, CharT>
+            , strf::width_as_fast_u32len{}, sample.str );
+        benchmark::RegisterBenchmark
+            ( robust_name.c_str(), bm_precision<strf::width_as_u32len, CharT>
+            , strf::width_as_u32len{}, sample.str );
+    }
+}
+
 CREATE_BENCHMARK( U8_F_5);
 CREATE_BENCHMARK( U8_F32L_5);
 CREATE_BENCHMARK( U8_32L_5);
@@ -200,6 +263,9 @@ int main(int argc, char** argv)
     REGISTER_BENCHMARK( CV_32L_J50);
     REGISTER_BENCHMARK( CV_C_J50);
 
+    register_precision_benchmarks<char>("u8", "u8dest");
+    register_precision_benchmarks<char16_t>("u16", "u16dest");
+
     benchmark::Initialize(&argc, argv);
     benchmark::RunSpecifiedBenchmarks();
 
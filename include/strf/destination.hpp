@@ -771,6 +771,212 @@ inline STRF_HD auto to(wchar_t* dest, std::size_t count)
 }
 
 
+namespace detail {
+
+template <typename CharT>
+class basic_cstr_counting_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using finish_type = typename basic_cstr_counting_writer<CharT>::result;
+    using outbuff_type = basic_cstr_counting_writer<CharT>;
+
+    constexpr STRF_HD
+    basic_cstr_counting_writer_creator(CharT* dest, CharT* dest_end) noexcept
+        : dest_(dest)
+        , dest_end_(dest_end)
+    {
+        STRF_ASSERT(dest < dest_end);
+    }
+
+    STRF_HD typename basic_cstr_counting_writer<CharT>::range create() const noexcept
+    {
+        return typename basic_cstr_counting_writer<CharT>::range{dest_, dest_end_};
+    }
+
+private:
+
+    CharT* dest_;
+    CharT* dest_end_;
+};
+
+} // namespace detail
+
+template<typename CharT, std::size_t N>
+inline STRF_HD auto to_counting(CharT (&dest)[N])
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_cstr_counting_writer_creator<CharT> >
+        (dest, dest + N);
+}
+
+template<typename CharT>
+inline STRF_HD auto to_counting(CharT* dest, CharT* end)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_cstr_counting_writer_creator<CharT> >
+        (dest, end);
+}
+
+template<typename CharT>
+inline STRF_HD auto to_counting(CharT* dest, std::size_t count)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_cstr_counting_writer_creator<CharT> >
+        (dest, dest + count);
+}
+
+struct measure_result
+{
+    std::size_t size;
+    strf::width_t width;
+};
+
+// Calculates the size and the width of the content without writing it.
+// Only the printers' constructors are executed, as when reserve_calc()
+// is used, but print_to is never called.
+template <typename CharT, typename FPack = strf::facets_pack<>>
+class basic_measurer
+{
+    template <typename Preview, typename Arg>
+    using printer_ = strf::printer_type<CharT, Preview, FPack, Arg>;
+
+public:
+
+    constexpr basic_measurer() = default;
+
+    constexpr STRF_HD explicit basic_measurer(const FPack& fp)
+        : fpack_(fp)
+    {
+    }
+
+    template <typename ... FPE>
+    STRF_NODISCARD constexpr STRF_HD auto with(FPE&& ... fpe) const
+    {
+        using NewFPack = decltype( strf::pack( std::declval<const FPack&>()
+                                             , std::forward<FPE>(fpe) ...) );
+        return basic_measurer<CharT, NewFPack>
+            { strf::pack(fpack_, std::forward<FPE>(fpe)...) };
+    }
+
+    // Returns the size and the width. The width saturates at strf::width_max.
+    template <typename ... Args>
+    STRF_HD strf::measure_result operator()(const Args& ... args) const
+    {
+        strf::print_size_and_width_preview preview{strf::width_max};
+        measure_(preview, args...);
+        return { preview.accumulated_size()
+               , strf::width_max - preview.remaining_width() };
+    }
+
+    // Returns only the size, which is usually faster to calculate.
+    template <typename ... Args>
+    STRF_HD std::size_t size(const Args& ... args) const
+    {
+        strf::print_size_preview preview;
+        measure_(preview, args...);
+        return preview.accumulated_size();
+    }
+
+#if defined(STRF_HAS_STD_STRING_VIEW)
+
+    template <typename ... Args>
+    STRF_HD std::size_t tr
+        ( const std::basic_string_view<CharT>& str
+        , const Args& ... args ) const
+    {
+        return tr_( str.data(), str.data() + str.size()
+                  , std::make_index_sequence<sizeof...(args)>(), args... );
+    }
+
+#else
+
+    template <typename ... Args>
+    STRF_HD std::size_t tr(const CharT* str, const Args& ... args) const
+    {
+        return tr_( str, str + strf::detail::str_length<CharT>(str)
+                  , std::make_index_sequence<sizeof...(args)>(), args... );
+    }
+
+#endif
+
+private:
+
+    template <typename Preview, typename ... Args>
+    STRF_HD void measure_(Preview& preview, const Args& ... args) const
+    {
+        using swallow_ = int[];
+        (void) swallow_
+            { 0
+            , ( (void) printer_<Preview, Args>
+                  ( strf::make_printer_input<CharT>(preview, fpack_, args) )
+              , 0 )... };
+    }
+
+    static inline const strf::printer<CharT>*
+    STRF_HD as_printer_cptr_(const strf::printer<CharT>& p)
+    {
+         return &p;
+    }
+
+    template < std::size_t ... I, typename ... Args >
+    STRF_HD std::size_t tr_
+        ( const CharT* str
+        , const CharT* str_end
+        , std::index_sequence<I...>
+        , const Args& ... args) const
+    {
+        using preview_type = strf::print_size_preview;
+        constexpr std::size_t args_count = sizeof...(args);
+        preview_type preview_arr[args_count ? args_count : 1];
+        return tr_2_
+            ( str
+            , str_end
+            , preview_arr
+            , { as_printer_cptr_
+                ( printer_<preview_type, Args>
+                  ( strf::make_printer_input<CharT>
+                    ( preview_arr[I], fpack_, args ) ) )... } );
+    }
+
+    STRF_HD std::size_t tr_2_
+        ( const CharT* str
+        , const CharT* str_end
+        , strf::print_size_preview* preview_arr
+        , std::initializer_list<const strf::printer<CharT>*> args ) const
+    {
+        using catenc = strf::char_encoding_c<CharT>;
+        auto enc = strf::get_facet<catenc, void>(fpack_);
+
+        using caterr = strf::tr_error_notifier_c;
+        decltype(auto) err_hdl = strf::get_facet<caterr, void>(fpack_);
+        using err_hdl_type = std::remove_cv_t<std::remove_reference_t<decltype(err_hdl)>>;
+
+        strf::print_size_preview preview;
+        strf::detail::tr_string_printer<decltype(enc), err_hdl_type>
+            tr_printer(preview, preview_arr, args, str, str_end, enc, err_hdl);
+        return preview.accumulated_size();
+    }
+
+    FPack fpack_;
+};
+
+#if ! defined(STRF_NO_GLOBAL_CONSTEXPR_VARIABLE)
+
+template <typename CharT>
+constexpr strf::basic_measurer<CharT> basic_measure {};
+
+#if defined(__cpp_char8_t)
+constexpr strf::basic_measurer<char8_t> u8measure {};
+#endif
+constexpr strf::basic_measurer<char> measure {};
+constexpr strf::basic_measurer<char16_t> u16measure {};
+constexpr strf::basic_measurer<char32_t> u32measure {};
+constexpr strf::basic_measurer<wchar_t> wmeasure {};
+
+#endif // ! defined(STRF_NO_GLOBAL_CONSTEXPR_VARIABLE)
+
 } // namespace strf
 
 #endif  // STRF_DESTINATION_HPP
@@ -184,7 +184,7 @@ public:
         if (preview.remaining_width() > diff) {
             fillcount_ = (preview.remaining_width() - diff).round();
         }
-        width_t width = fillcount_ + wmax - preview.remaining_width();
+        width_t width = fillcount_ + (wmax - preview.remaining_width());
         input.preview.subtract_width(width);
         STRF_IF_CONSTEXPR (static_cast<bool>(ReqSize)) {
             input.preview.add_size(preview.accumulated_size());
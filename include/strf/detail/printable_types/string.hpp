@@ -661,7 +661,7 @@ template<typename SrcCharT, typename DestCharT>
 STRF_HD void string_printer<SrcCharT, DestCharT>::print_to
     ( strf::basic_outbuff<DestCharT>& ob ) const
 {
-    strf::detail::outbuff_interchar_copy(ob, str_, len_);
+    strf::detail::outbuff_borrow_or_copy(ob, str_, len_);
 }
 
 template <typename SrcCharT, typename DestCharT>
@@ -797,7 +797,7 @@ void STRF_HD aligned_string_printer<SrcCharT, DestCharT>::print_to
     if (left_fillcount_ > 0) {
         encode_fill_(ob, left_fillcount_, afmt_.fill);
     }
-    strf::detail::outbuff_interchar_copy(ob, str_, len_);
+    strf::detail::outbuff_borrow_or_copy(ob, str_, len_);
     if (right_fillcount_ > 0) {
         encode_fill_(ob, right_fillcount_, afmt_.fill);
     }
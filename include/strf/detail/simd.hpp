@@ -0,0 +1,1203 @@
+#ifndef STRF_DETAIL_SIMD_HPP
+#define STRF_DETAIL_SIMD_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/detail/strf_def.hpp>
+#include <cstdint>
+
+// Vectorized kernels used by the UTF transcoders. They only process whole
+// blocks, leaving the remaining characters to the scalar code. Define
+// STRF_NO_SIMD to disable them.
+
+#if ! defined(STRF_NO_SIMD) && ! defined(__CUDA_ARCH__)
+#  if defined(__AVX2__)
+#    define STRF_SIMD_AVX2
+#  endif
+#  if defined(__SSSE3__) || defined(__AVX__)
+#    define STRF_SIMD_SSSE3
+#  endif
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define STRF_SIMD_SSE2
+#  elif defined(__ARM_NEON) && defined(__aarch64__)
+#    define STRF_SIMD_NEON
+#  endif
+#endif
+
+// The static library built by CMake for x86 with GCC or Clang defines
+// STRF_SIMD_DISPATCH. It then also contains the kernels compiled for
+// SSSE3 and for AVX2 ( src/simd_ssse3.cpp and src/simd_avx2.cpp ), and
+// the code compiled for an older instruction set calls the best of them
+// that the CPU supports, instead of its inline ones.
+#if defined(STRF_SIMD_DISPATCH) && defined(STRF_SEPARATE_COMPILATION) \
+ && defined(STRF_SIMD_SSE2) && ! defined(STRF_SIMD_AVX2)             \
+ && ! defined(STRF_SIMD_TARGET) && ! defined(__CUDACC__)
+#  define STRF_SIMD_USE_DISPATCH
+#endif
+
+// The kernels below are placed in an inline namespace named after the
+// instruction set they are compiled for. Otherwise, in header-only use,
+// translation units compiled with different -m flags would define
+// different functions with the same mangled name, and the linker could
+// pick, for instance, the AVX2 one for code that runs on a CPU without
+// AVX2. CUDA compiles each file twice, for the host and for the device,
+// and the two passes must agree on the names, hence the exception.
+// This does not cover the inline functions and templates that call the
+// kernels ( the UTF transcoders in utf.hpp ). So, in header-only use, all
+// translation units must still be compiled for the same instruction set.
+// To get the best kernels of each CPU, use the static library with
+// STRF_SIMD_DISPATCH instead. Its SSSE3 and AVX2 translation units,
+// which define STRF_SIMD_TARGET, don't include utf.hpp, and give the
+// kernels internal linkage, so that they only export the kernels tables.
+#if defined(STRF_SIMD_TARGET)
+#  define STRF_SIMD_ISA STRF_SIMD_TARGET
+#elif defined(STRF_SIMD_AVX2)
+#  define STRF_SIMD_ISA isa_avx2
+#elif defined(STRF_SIMD_SSSE3)
+#  define STRF_SIMD_ISA isa_ssse3
+#elif defined(STRF_SIMD_USE_DISPATCH)
+#  define STRF_SIMD_ISA isa_sse2_dispatch
+#elif defined(STRF_SIMD_SSE2)
+#  define STRF_SIMD_ISA isa_sse2
+#elif defined(STRF_SIMD_NEON)
+#  define STRF_SIMD_ISA isa_neon
+#else
+#  define STRF_SIMD_ISA isa_none
+#endif
+
+#if defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+#  include <cstring>
+#endif
+#if defined(STRF_SIMD_DISPATCH) && defined(STRF_SOURCE) && ! defined(STRF_FREESTANDING)
+#  include <cstdlib>
+#endif
+
+#if defined(STRF_SIMD_SSE2)
+#  include <emmintrin.h>
+#  if defined(STRF_SIMD_SSSE3)
+#    include <tmmintrin.h>
+#  endif
+#  if defined(STRF_SIMD_AVX2)
+#    include <immintrin.h>
+#  endif
+#  if defined(_MSC_VER) && ! defined(__clang__)
+#    include <intrin.h>
+#  endif
+#elif defined(STRF_SIMD_NEON)
+#  include <arm_neon.h>
+#endif
+
+namespace strf {
+namespace detail {
+namespace simd {
+
+#if defined(STRF_SIMD_DISPATCH)
+
+struct kernels_table
+{
+    std::size_t (*widen_ascii)(const std::uint8_t*, std::size_t, std::uint16_t*) noexcept;
+    std::size_t (*ascii_prefix_length)(const std::uint8_t*, std::size_t) noexcept;
+    void (*utf16_to_utf8)
+        ( const std::uint16_t*&, const std::uint16_t*
+        , std::uint8_t*&, std::uint8_t* ) noexcept;
+    std::size_t (*utf8_valid_prefix_length)(const std::uint8_t*, std::size_t) noexcept;
+};
+
+// Defined in src/simd_ssse3.cpp and src/simd_avx2.cpp
+extern const kernels_table ssse3_kernels;
+extern const kernels_table avx2_kernels;
+
+// Returns the kernels of the best instruction set supported by the CPU,
+// or nullptr if it is not better than SSE2. It is selected once.
+STRF_FUNC const kernels_table* dispatched_kernels() noexcept;
+
+#endif // defined(STRF_SIMD_DISPATCH)
+
+#if defined(STRF_SIMD_TARGET)
+namespace {
+#endif
+#if ! defined(__CUDACC__)
+inline namespace STRF_SIMD_ISA {
+#endif
+
+#if defined(STRF_SIMD_SSE2)
+
+inline unsigned countr_zero(std::uint32_t x) noexcept
+{
+    STRF_ASSERT(x != 0);
+#if defined(_MSC_VER) && ! defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+#endif // defined(STRF_SIMD_SSE2)
+
+// Tells whether the 8 bytes starting at src are all ASCII. The
+// transcoders use it to decide whether an ASCII run is long enough to be
+// worth the vectorized path. Always false when SIMD is not available.
+inline STRF_HD bool is_ascii_word(const std::uint8_t* src) noexcept
+{
+#if defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+    std::uint64_t word;
+    std::memcpy(&word, src, sizeof(word));
+    return (word & 0x8080808080808080ULL) == 0;
+#else
+    (void) src;
+    return false;
+#endif
+}
+
+// Writes into dest the longest prefix of [src, src + size) that only
+// contains ASCII characters, converting each byte to a 16-bit code unit.
+// Returns the length of such prefix. It may write up to one block of
+// garbage after the prefix, but never beyond dest + size.
+template <typename DestCharT>
+inline STRF_HD std::size_t widen_ascii
+    ( const std::uint8_t* src
+    , std::size_t size
+    , DestCharT* dest ) noexcept
+{
+    static_assert(sizeof(DestCharT) == 2, "");
+
+#if defined(STRF_SIMD_USE_DISPATCH)
+    if (const auto* kernels = strf::detail::simd::dispatched_kernels()) {
+        return kernels->widen_ascii(src, size, reinterpret_cast<std::uint16_t*>(dest));
+    }
+#endif
+#if defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+
+    std::size_t count = 0;
+
+#if defined(STRF_SIMD_AVX2)
+
+    for (; count + 32 <= size; count += 32) {
+        auto* d = reinterpret_cast<__m256i*>(dest + count);
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + count));
+        _mm256_storeu_si256(d, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+        _mm256_storeu_si256(d + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+        if (mask != 0) {
+            return count + strf::detail::simd::countr_zero(mask);
+        }
+    }
+
+#endif // defined(STRF_SIMD_AVX2)
+#if defined(STRF_SIMD_SSE2)
+
+    const __m128i zero = _mm_setzero_si128();
+    for (; count + 16 <= size; count += 16) {
+        auto* d = reinterpret_cast<__m128i*>(dest + count);
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count));
+        _mm_storeu_si128(d, _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(d + 1, _mm_unpackhi_epi8(v, zero));
+        const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+        if (mask != 0) {
+            return count + strf::detail::simd::countr_zero(mask);
+        }
+    }
+
+#else // defined(STRF_SIMD_NEON)
+
+    for (; count + 16 <= size; count += 16) {
+        const uint8x16_t v = vld1q_u8(src + count);
+        auto* d = reinterpret_cast<std::uint16_t*>(dest + count);
+        vst1q_u16(d, vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(d + 8, vmovl_u8(vget_high_u8(v)));
+        if (vmaxvq_u8(v) >= 0x80) {
+            while (src[count] < 0x80) {
+                ++count;
+            }
+            return count;
+        }
+    }
+
+#endif
+    return count;
+
+#else  // defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+
+    (void) src;
+    (void) size;
+    (void) dest;
+    return 0;
+
+#endif
+}
+
+// Returns the length of the longest prefix of [src, src + size) that
+// only contains ASCII characters, or some smaller value, since the
+// last partial block is not inspected.
+inline STRF_HD std::size_t ascii_prefix_length
+    ( const std::uint8_t* src
+    , std::size_t size ) noexcept
+{
+#if defined(STRF_SIMD_USE_DISPATCH)
+    if (const auto* kernels = strf::detail::simd::dispatched_kernels()) {
+        return kernels->ascii_prefix_length(src, size);
+    }
+#endif
+#if defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+
+    std::size_t count = 0;
+
+#if defined(STRF_SIMD_AVX2)
+
+    for (; count + 32 <= size; count += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + count));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+        if (mask != 0) {
+            return count + strf::detail::simd::countr_zero(mask);
+        }
+    }
+
+#endif // defined(STRF_SIMD_AVX2)
+#if defined(STRF_SIMD_SSE2)
+
+    for (; count + 16 <= size; count += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count));
+        const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+        if (mask != 0) {
+            return count + strf::detail::simd::countr_zero(mask);
+        }
+    }
+
+#else // defined(STRF_SIMD_NEON)
+
+    for (; count + 16 <= size; count += 16) {
+        if (vmaxvq_u8(vld1q_u8(src + count)) >= 0x80) {
+            while (src[count] < 0x80) {
+                ++count;
+            }
+            return count;
+        }
+    }
+
+#endif
+    return count;
+
+#else  // defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+
+    (void) src;
+    (void) size;
+    return 0;
+
+#endif
+}
+
+#if defined(STRF_SIMD_SSSE3) || defined(STRF_SIMD_NEON)
+
+// Byte shuffles that compact a block of eight code units already encoded
+// in two bytes each, dropping the second byte of those that are ASCII.
+// Indexed by the bitmask of the ASCII units.
+struct utf8_compact_table
+{
+    std::uint8_t shuffle[256][16];
+    std::uint8_t size[256];
+};
+
+constexpr utf8_compact_table make_utf8_compact_table() noexcept
+{
+    utf8_compact_table t{};
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        unsigned n = 0;
+        for (unsigned i = 0; i < 8; ++i) {
+            t.shuffle[mask][n++] = static_cast<std::uint8_t>(2 * i);
+            if ((mask & (1u << i)) == 0) {
+                t.shuffle[mask][n++] = static_cast<std::uint8_t>(2 * i + 1);
+            }
+        }
+        t.size[mask] = static_cast<std::uint8_t>(n);
+        for (; n < 16; ++n) {
+            t.shuffle[mask][n] = 0x80;
+        }
+    }
+    return t;
+}
+
+template <typename T = void>
+struct utf8_compact_table_holder
+{
+    static constexpr utf8_compact_table table = make_utf8_compact_table();
+};
+
+template <typename T>
+constexpr utf8_compact_table utf8_compact_table_holder<T>::table;
+
+#endif // defined(STRF_SIMD_SSSE3) || defined(STRF_SIMD_NEON)
+
+// Tells whether utf16_to_utf8 converts the block of eight code units
+// starting at src, judging only from the kinds of code units it has.
+// Without SSSE3, these are only the blocks that are all ASCII or all
+// two-byte sequences. The transcoder uses it to not leave the scalar
+// loop for blocks that would make the vectorized path stop anyway.
+// Always false when SIMD is not available.
+template <typename SrcCharT>
+inline STRF_HD bool utf16_to_utf8_accepts(const SrcCharT* src) noexcept
+{
+#if defined(STRF_SIMD_SSE2)
+
+    if (sizeof(SrcCharT) != 2) {
+        return false;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i v_f800 = _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800)));
+    const auto two_bytes_or_less_mask = _mm_movemask_epi8(_mm_cmpeq_epi16(v_f800, zero));
+#if defined(STRF_SIMD_SSSE3) || defined(STRF_SIMD_USE_DISPATCH)
+    return two_bytes_or_less_mask == 0xFFFF
+        || ( two_bytes_or_less_mask == 0
+          && 0 == _mm_movemask_epi8
+               (_mm_cmpeq_epi16(v_f800, _mm_set1_epi16(static_cast<short>(0xD800)))) );
+#else
+    const auto ascii_mask = _mm_movemask_epi8
+        (_mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80))), zero));
+    return ascii_mask == 0xFFFF || (ascii_mask == 0 && two_bytes_or_less_mask == 0xFFFF);
+#endif
+
+#elif defined(STRF_SIMD_NEON)
+
+    if (sizeof(SrcCharT) != 2) {
+        return false;
+    }
+    const uint16x8_t v = vld1q_u16(reinterpret_cast<const std::uint16_t*>(src));
+    const uint16x8_t is_surrogate = vceqq_u16
+        ( vandq_u16(v, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800) );
+    return vmaxvq_u16(v) < 0x800
+        || (vminvq_u16(v) >= 0x800 && vmaxvq_u16(is_surrogate) == 0);
+
+#else
+
+    (void) src;
+    return false;
+
+#endif
+}
+
+// Converts blocks of eight UTF-16 code units into UTF-8, advancing src
+// and dest. It stops at the first block that contains a surrogate or
+// that mixes code units it can not handle together, or when there are
+// less than eight code units left or less than 32 bytes of space in dest.
+// So the scalar code is still responsible for everything else, including
+// the surrogate_policy. It does nothing when sizeof(SrcCharT) != 2.
+template <typename SrcCharT, typename DestCharT>
+inline STRF_HD void utf16_to_utf8
+    ( const SrcCharT*& src
+    , const SrcCharT* src_end
+    , DestCharT*& dest
+    , DestCharT* dest_end ) noexcept
+{
+#if defined(STRF_SIMD_SSE2)
+
+    if (sizeof(SrcCharT) != 2 || sizeof(DestCharT) != 1) {
+        return;
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask_ff80 = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i mask_f800 = _mm_set1_epi16(static_cast<short>(0xF800));
+    const __m128i mask_3f = _mm_set1_epi16(0x3F);
+    while (src_end - src >= 8 && dest_end - dest >= 32) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        auto* d = reinterpret_cast<__m128i*>(dest);
+        const __m128i is_ascii = _mm_cmpeq_epi16(_mm_and_si128(v, mask_ff80), zero);
+        const auto ascii_mask = static_cast<unsigned>(_mm_movemask_epi8(is_ascii));
+        if (ascii_mask == 0xFFFF) {
+            _mm_storel_epi64(d, _mm_packus_epi16(v, v));
+            src += 8;
+            dest += 8;
+            continue;
+        }
+        const __m128i is_two_bytes_or_less = _mm_cmpeq_epi16(_mm_and_si128(v, mask_f800), zero);
+        const auto two_bytes_or_less_mask =
+            static_cast<unsigned>(_mm_movemask_epi8(is_two_bytes_or_less));
+        if (two_bytes_or_less_mask == 0xFFFF) {
+            // Each code unit is encoded as ( lead | (continuation << 8) )
+            const __m128i lead = _mm_or_si128(_mm_srli_epi16(v, 6), _mm_set1_epi16(0xC0));
+            const __m128i cont = _mm_or_si128(_mm_and_si128(v, mask_3f), _mm_set1_epi16(0x80));
+            const __m128i two_bytes = _mm_or_si128(lead, _mm_slli_epi16(cont, 8));
+            if (ascii_mask == 0) {
+                _mm_storeu_si128(d, two_bytes);
+                src += 8;
+                dest += 16;
+                continue;
+            }
+#if defined(STRF_SIMD_SSSE3)
+            const __m128i words = _mm_or_si128
+                ( _mm_and_si128(is_ascii, v)
+                , _mm_andnot_si128(is_ascii, two_bytes) );
+            const auto m = static_cast<unsigned>
+                (_mm_movemask_epi8(_mm_packs_epi16(is_ascii, zero)));
+            const auto& table = strf::detail::simd::utf8_compact_table_holder<>::table;
+            const __m128i shuffle = _mm_loadu_si128
+                (reinterpret_cast<const __m128i*>(table.shuffle[m]));
+            _mm_storeu_si128(d, _mm_shuffle_epi8(words, shuffle));
+            src += 8;
+            dest += table.size[m];
+            continue;
+#else
+            break;
+#endif
+        }
+#if defined(STRF_SIMD_SSSE3)
+        const __m128i is_surrogate = _mm_cmpeq_epi16
+            ( _mm_and_si128(v, mask_f800), _mm_set1_epi16(static_cast<short>(0xD800)) );
+        if (two_bytes_or_less_mask == 0 && _mm_movemask_epi8(is_surrogate) == 0) {
+            // Each code unit is encoded as
+            // ( b0 | (b1 << 8) | (b2 << 16) ) in a 32-bit lane.
+            const __m128i shuffle = _mm_setr_epi8
+                ( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+            const __m128i halves[2] = { _mm_unpacklo_epi16(v, zero)
+                                      , _mm_unpackhi_epi16(v, zero) };
+            for (const __m128i& x : halves) {
+                const __m128i b0 = _mm_or_si128
+                    ( _mm_srli_epi32(x, 12), _mm_set1_epi32(0xE0) );
+                const __m128i b1 = _mm_or_si128
+                    ( _mm_and_si128(_mm_srli_epi32(x, 6), _mm_set1_epi32(0x3F))
+                    , _mm_set1_epi32(0x80) );
+                const __m128i b2 = _mm_or_si128
+                    ( _mm_and_si128(x, _mm_set1_epi32(0x3F))
+                    , _mm_set1_epi32(0x80) );
+                const __m128i t = _mm_or_si128
+                    ( b0, _mm_or_si128(_mm_slli_epi32(b1, 8), _mm_slli_epi32(b2, 16)) );
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_shuffle_epi8(t, shuffle));
+                dest += 12;
+            }
+            src += 8;
+            continue;
+        }
+#endif // defined(STRF_SIMD_SSSE3)
+        break;
+    }
+#if defined(STRF_SIMD_USE_DISPATCH)
+    // The ASCII and two-byte blocks are handled inline above, since the
+    // indirect call does not pay off for short strings. The kernels
+    // selected at run time take over from the first block that needs more.
+    if (src_end - src >= 8 && dest_end - dest >= 32) {
+        if (const auto* kernels = strf::detail::simd::dispatched_kernels()) {
+            const auto* const src_u16 = reinterpret_cast<const std::uint16_t*>(src);
+            auto* const dest_u8 = reinterpret_cast<std::uint8_t*>(dest);
+            const auto* src_it = src_u16;
+            auto* dest_it = dest_u8;
+            kernels->utf16_to_utf8
+                ( src_it, reinterpret_cast<const std::uint16_t*>(src_end)
+                , dest_it, reinterpret_cast<std::uint8_t*>(dest_end) );
+            src += src_it - src_u16;
+            dest += dest_it - dest_u8;
+        }
+    }
+#endif
+
+#elif defined(STRF_SIMD_NEON)
+
+    if (sizeof(SrcCharT) != 2 || sizeof(DestCharT) != 1) {
+        return;
+    }
+    static const std::uint16_t lane_bits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    const uint16x8_t mask_3f = vdupq_n_u16(0x3F);
+    const uint16x8_t cont_tag = vdupq_n_u16(0x80);
+    while (src_end - src >= 8 && dest_end - dest >= 32) {
+        const uint16x8_t v = vld1q_u16(reinterpret_cast<const std::uint16_t*>(src));
+        auto* d = reinterpret_cast<std::uint8_t*>(dest);
+        const std::uint16_t max = vmaxvq_u16(v);
+        if (max < 0x80) {
+            vst1_u8(d, vmovn_u16(v));
+            src += 8;
+            dest += 8;
+        } else if (max < 0x800) {
+            const uint16x8_t lead = vorrq_u16(vshrq_n_u16(v, 6), vdupq_n_u16(0xC0));
+            const uint16x8_t cont = vorrq_u16(vandq_u16(v, mask_3f), cont_tag);
+            if (vminvq_u16(v) >= 0x80) {
+                const uint8x8x2_t bytes = {{ vmovn_u16(lead), vmovn_u16(cont) }};
+                vst2_u8(d, bytes);
+                src += 8;
+                dest += 16;
+            } else {
+                const uint16x8_t is_ascii = vcltq_u16(v, cont_tag);
+                const uint16x8_t words = vbslq_u16
+                    ( is_ascii, v, vorrq_u16(lead, vshlq_n_u16(cont, 8)) );
+                const unsigned m = vaddvq_u16(vandq_u16(is_ascii, vld1q_u16(lane_bits)));
+                const auto& table = strf::detail::simd::utf8_compact_table_holder<>::table;
+                vst1q_u8(d, vqtbl1q_u8(vreinterpretq_u8_u16(words), vld1q_u8(table.shuffle[m])));
+                src += 8;
+                dest += table.size[m];
+            }
+        } else if ( vminvq_u16(v) >= 0x800
+                 && vmaxvq_u16(vceqq_u16( vandq_u16(v, vdupq_n_u16(0xF800))
+                                        , vdupq_n_u16(0xD800) )) == 0 ) {
+            const uint8x8x3_t bytes =
+                {{ vmovn_u16(vorrq_u16(vshrq_n_u16(v, 12), vdupq_n_u16(0xE0)))
+                 , vmovn_u16(vorrq_u16(vandq_u16(vshrq_n_u16(v, 6), mask_3f), cont_tag))
+                 , vmovn_u16(vorrq_u16(vandq_u16(v, mask_3f), cont_tag)) }};
+            vst3_u8(d, bytes);
+            src += 8;
+            dest += 24;
+        } else {
+            break;
+        }
+    }
+
+#else
+
+    (void) src;
+    (void) src_end;
+    (void) dest;
+    (void) dest_end;
+
+#endif
+}
+
+// Returns the UTF-8 size of the blocks of eight UTF-16 code units
+// starting at src, advancing src past them. A surrogate pair split
+// between the last block and the code units after it is not counted:
+// src is then left at its high surrogate.
+template <typename SrcCharT>
+inline STRF_HD std::size_t utf16_to_utf8_size
+    ( const SrcCharT*& src
+    , const SrcCharT* src_end ) noexcept
+{
+#if defined(STRF_SIMD_SSE2)
+
+    if (sizeof(SrcCharT) != 2) {
+        return 0;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask_ff80 = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i mask_f800 = _mm_set1_epi16(static_cast<short>(0xF800));
+    const __m128i mask_fc00 = _mm_set1_epi16(static_cast<short>(0xFC00));
+    const __m128i high_surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+    const __m128i low_surrogate = _mm_set1_epi16(static_cast<short>(0xDC00));
+    const SrcCharT* const src_begin = src;
+    // Each code unit takes three bytes, minus one if it is ASCII, minus
+    // one if it takes two bytes or less, and minus two if it is a low
+    // surrogate that follows a high one ( so that the pair takes four ).
+    // These subtrahends are accumulated in the 16-bit lanes of counts,
+    // which are summed every 0x10000 code units, before they overflow.
+    std::size_t subtrahends = 0;
+    __m128i previous_is_high = zero;
+    while (src_end - src >= 8) {
+        const SrcCharT* const chunk_end = src_end - src > 0x10000 ? src + 0x10000 : src_end;
+        __m128i counts = zero;
+        for (; chunk_end - src >= 8; src += 8) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i is_ascii = _mm_cmpeq_epi16(_mm_and_si128(v, mask_ff80), zero);
+            const __m128i is_two_bytes_or_less = _mm_cmpeq_epi16(_mm_and_si128(v, mask_f800), zero);
+            const __m128i v_fc00 = _mm_and_si128(v, mask_fc00);
+            const __m128i is_high = _mm_cmpeq_epi16(v_fc00, high_surrogate);
+            const __m128i follows_high = _mm_or_si128
+                ( _mm_slli_si128(is_high, 2), _mm_srli_si128(previous_is_high, 14) );
+            const __m128i is_paired_low = _mm_and_si128
+                ( _mm_cmpeq_epi16(v_fc00, low_surrogate), follows_high );
+            counts = _mm_sub_epi16(counts, _mm_add_epi16(is_ascii, is_two_bytes_or_less));
+            counts = _mm_sub_epi16(counts, _mm_add_epi16(is_paired_low, is_paired_low));
+            previous_is_high = is_high;
+        }
+        __m128i sum = _mm_madd_epi16(counts, _mm_set1_epi16(1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        subtrahends += static_cast<std::uint32_t>(_mm_cvtsi128_si32(sum));
+    }
+    if (_mm_movemask_epi8(previous_is_high) & 0x8000) {
+        --src; // leave the high surrogate to the caller
+    }
+    return 3 * static_cast<std::size_t>(src - src_begin) - subtrahends;
+
+#elif defined(STRF_SIMD_NEON)
+
+    if (sizeof(SrcCharT) != 2) {
+        return 0;
+    }
+    const uint16x8_t zero = vdupq_n_u16(0);
+    const uint16x8_t one = vdupq_n_u16(1);
+    const SrcCharT* const src_begin = src;
+    // As in the SSE2 version
+    std::size_t subtrahends = 0;
+    uint16x8_t previous_is_high = zero;
+    while (src_end - src >= 8) {
+        const SrcCharT* const chunk_end = src_end - src > 0x10000 ? src + 0x10000 : src_end;
+        uint16x8_t counts = zero;
+        for (; chunk_end - src >= 8; src += 8) {
+            const uint16x8_t v = vld1q_u16(reinterpret_cast<const std::uint16_t*>(src));
+            const uint16x8_t v_fc00 = vandq_u16(v, vdupq_n_u16(0xFC00));
+            const uint16x8_t is_high = vceqq_u16(v_fc00, vdupq_n_u16(0xD800));
+            const uint16x8_t is_paired_low = vandq_u16
+                ( vceqq_u16(v_fc00, vdupq_n_u16(0xDC00))
+                , vextq_u16(previous_is_high, is_high, 7) );
+            counts = vaddq_u16(counts, vandq_u16(vcltq_u16(v, vdupq_n_u16(0x80)), one));
+            counts = vaddq_u16(counts, vandq_u16(vcltq_u16(v, vdupq_n_u16(0x800)), one));
+            counts = vaddq_u16(counts, vandq_u16(is_paired_low, vdupq_n_u16(2)));
+            previous_is_high = is_high;
+        }
+        subtrahends += vaddlvq_u16(counts);
+    }
+    if (vgetq_lane_u16(previous_is_high, 7) != 0) {
+        --src; // leave the high surrogate to the caller
+    }
+    return 3 * static_cast<std::size_t>(src - src_begin) - subtrahends;
+
+#else
+
+    (void) src;
+    (void) src_end;
+    return 0;
+
+#endif
+}
+
+// Returns how many of the last bytes before src + pos belong to a
+// UTF-8 sequence that is not complete at src + pos. The bytes in
+// [src, src + pos) are assumed to be valid UTF-8.
+inline STRF_HD std::size_t utf8_incomplete_tail
+    ( const std::uint8_t* src
+    , std::size_t pos ) noexcept
+{
+    for (std::size_t k = 1; k <= 3 && k <= pos; ++k) {
+        const std::uint8_t ch = src[pos - k];
+        if ((ch & 0xC0) == 0x80) {
+            continue;
+        }
+        const std::size_t len = ch >= 0xF0 ? 4 : ch >= 0xE0 ? 3 : ch >= 0xC0 ? 2 : 1;
+        return len > k ? k : 0;
+    }
+    return 0;
+}
+
+#if defined(STRF_SIMD_SSSE3) || defined(STRF_SIMD_NEON)
+
+// Flags used by the UTF-8 validation algorithm of
+// John Keiser and Daniel Lemire ( https://arxiv.org/abs/2010.03090 )
+// Each one describes an error that a pair of consecutive bytes may have.
+enum utf8_check_flags : std::uint8_t
+{
+    utf8_too_short      = 1 << 0,
+    utf8_too_long       = 1 << 1,
+    utf8_overlong_3     = 1 << 2,
+    utf8_too_large      = 1 << 3,
+    utf8_surrogate      = 1 << 4,
+    utf8_overlong_2     = 1 << 5,
+    utf8_too_large_1000 = 1 << 6,
+    utf8_overlong_4     = 1 << 6,
+    utf8_two_conts      = 1 << 7,
+    utf8_carry          = utf8_too_short | utf8_too_long | utf8_two_conts
+};
+
+template <typename T = void>
+struct utf8_check_tables
+{
+    // indexed by the high nibble of the first byte
+    static constexpr std::uint8_t byte_1_high[16] =
+        { utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long
+        , utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long
+        , utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts
+        , utf8_too_short | utf8_overlong_2
+        , utf8_too_short
+        , utf8_too_short | utf8_overlong_3 | utf8_surrogate
+        , utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4 };
+
+    // indexed by the low nibble of the first byte
+    static constexpr std::uint8_t byte_1_low[16] =
+        { utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4
+        , utf8_carry | utf8_overlong_2
+        , utf8_carry
+        , utf8_carry
+        , utf8_carry | utf8_too_large
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate
+        , utf8_carry | utf8_too_large | utf8_too_large_1000
+        , utf8_carry | utf8_too_large | utf8_too_large_1000 };
+
+    // indexed by the high nibble of the second byte
+    static constexpr std::uint8_t byte_2_high[16] =
+        { utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short
+        , utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short
+        , utf8_too_long | utf8_overlong_2 | utf8_two_conts
+          | utf8_overlong_3 | utf8_too_large_1000 | utf8_overlong_4
+        , utf8_too_long | utf8_overlong_2 | utf8_two_conts
+          | utf8_overlong_3 | utf8_too_large
+        , utf8_too_long | utf8_overlong_2 | utf8_two_conts
+          | utf8_surrogate | utf8_too_large
+        , utf8_too_long | utf8_overlong_2 | utf8_two_conts
+          | utf8_surrogate | utf8_too_large
+        , utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short };
+};
+
+template <typename T>
+constexpr std::uint8_t utf8_check_tables<T>::byte_1_high[16];
+
+template <typename T>
+constexpr std::uint8_t utf8_check_tables<T>::byte_1_low[16];
+
+template <typename T>
+constexpr std::uint8_t utf8_check_tables<T>::byte_2_high[16];
+
+#endif // defined(STRF_SIMD_SSSE3) || defined(STRF_SIMD_NEON)
+
+// Returns the length of a prefix of [src, src + size) that is valid
+// UTF-8 ( with surrogates being invalid ) and that does not end in
+// the middle of a multi-byte sequence. It inspects 16-byte blocks and
+// stops at the first block that has an error, so the returned prefix
+// is not always the longest one. It returns zero when SSSE3 or NEON is
+// not available ( accepting only ASCII blocks with SSE2 turned out to be
+// slower than the scalar code on non-ASCII text ), or when
+// sizeof(CharT) != 1.
+template <typename CharT>
+inline STRF_HD std::size_t utf8_valid_prefix_length
+    ( const CharT* src_
+    , std::size_t size ) noexcept
+{
+    if (sizeof(CharT) != 1) {
+        return 0;
+    }
+    const auto* src = reinterpret_cast<const std::uint8_t*>(src_);
+
+#if defined(STRF_SIMD_USE_DISPATCH)
+    if (const auto* kernels = strf::detail::simd::dispatched_kernels()) {
+        return kernels->utf8_valid_prefix_length(src, size);
+    }
+#endif
+
+#if defined(STRF_SIMD_SSSE3)
+
+    using tables = strf::detail::simd::utf8_check_tables<>;
+    const __m128i byte_1_high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables::byte_1_high));
+    const __m128i byte_1_low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables::byte_1_low));
+    const __m128i byte_2_high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables::byte_2_high));
+    const __m128i mask_0f = _mm_set1_epi8(0x0F);
+    const __m128i mask_80 = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i third_byte_threshold = _mm_set1_epi8(static_cast<char>(0xE0 - 0x80));
+    const __m128i fourth_byte_threshold = _mm_set1_epi8(static_cast<char>(0xF0 - 0x80));
+
+    __m128i prev = _mm_setzero_si128();
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+        if (_mm_movemask_epi8(_mm_or_si128(input, prev)) == 0) {
+            prev = input;
+            continue;
+        }
+        const __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+        const __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+        const __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+        const __m128i special_cases = _mm_and_si128
+            ( _mm_and_si128
+                ( _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), mask_0f))
+                , _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, mask_0f)) )
+            , _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), mask_0f)) );
+        const __m128i must_be_2_3_continuation = _mm_and_si128
+            ( _mm_or_si128
+                ( _mm_subs_epu8(prev2, third_byte_threshold)
+                , _mm_subs_epu8(prev3, fourth_byte_threshold) )
+            , mask_80 );
+        const __m128i error = _mm_xor_si128(must_be_2_3_continuation, special_cases);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF) {
+            break;
+        }
+        prev = input;
+    }
+    return pos - strf::detail::simd::utf8_incomplete_tail(src, pos);
+
+#elif defined(STRF_SIMD_NEON)
+
+    using tables = strf::detail::simd::utf8_check_tables<>;
+    const uint8x16_t byte_1_high = vld1q_u8(tables::byte_1_high);
+    const uint8x16_t byte_1_low  = vld1q_u8(tables::byte_1_low);
+    const uint8x16_t byte_2_high = vld1q_u8(tables::byte_2_high);
+    const uint8x16_t mask_0f = vdupq_n_u8(0x0F);
+    const uint8x16_t mask_80 = vdupq_n_u8(0x80);
+    const uint8x16_t third_byte_threshold = vdupq_n_u8(0xE0 - 0x80);
+    const uint8x16_t fourth_byte_threshold = vdupq_n_u8(0xF0 - 0x80);
+
+    uint8x16_t prev = vdupq_n_u8(0);
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const uint8x16_t input = vld1q_u8(src + pos);
+        if (vmaxvq_u8(vorrq_u8(input, prev)) < 0x80) {
+            prev = input;
+            continue;
+        }
+        const uint8x16_t prev1 = vextq_u8(prev, input, 15);
+        const uint8x16_t prev2 = vextq_u8(prev, input, 14);
+        const uint8x16_t prev3 = vextq_u8(prev, input, 13);
+        const uint8x16_t special_cases = vandq_u8
+            ( vandq_u8
+                ( vqtbl1q_u8(byte_1_high, vshrq_n_u8(prev1, 4))
+                , vqtbl1q_u8(byte_1_low, vandq_u8(prev1, mask_0f)) )
+            , vqtbl1q_u8(byte_2_high, vshrq_n_u8(input, 4)) );
+        const uint8x16_t must_be_2_3_continuation = vandq_u8
+            ( vorrq_u8
+                ( vqsubq_u8(prev2, third_byte_threshold)
+                , vqsubq_u8(prev3, fourth_byte_threshold) )
+            , mask_80 );
+        if (vmaxvq_u8(veorq_u8(must_be_2_3_continuation, special_cases)) != 0) {
+            break;
+        }
+        prev = input;
+    }
+    return pos - strf::detail::simd::utf8_incomplete_tail(src, pos);
+
+#else
+
+    (void) src;
+    (void) size;
+    return 0;
+
+#endif
+}
+
+// Counts the code points in whole 16-byte blocks of UTF-8, i.e. the
+// bytes that are not continuation bytes, stopping before `count` could
+// reach max_count. Adds the code points into `count` and returns the
+// number of bytes inspected, which may end in the middle of a multi-byte
+// sequence.
+inline STRF_HD std::size_t utf8_count_codepoints
+    ( const std::uint8_t* src
+    , std::size_t size
+    , std::size_t max_count
+    , std::size_t& count ) noexcept
+{
+    std::size_t pos = 0;
+
+#if defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+
+    while (count < max_count) {
+        // Each block has at most 16 code points. So take as many blocks as
+        // can not make the count reach max_count, and no more than 255,
+        // so that the 8-bit counters of each lane don't overflow.
+        std::size_t blocks = (size - pos) / 16;
+        const std::size_t max_blocks = (max_count - count - 1) / 16;
+        blocks = blocks < max_blocks ? blocks : max_blocks;
+        blocks = blocks < 255 ? blocks : 255;
+        if (blocks == 0) {
+            break;
+        }
+
+#if defined(STRF_SIMD_SSE2)
+
+        // continuation bytes are the ones in [-128, -65] as signed integers
+        const __m128i last_continuation = _mm_set1_epi8(static_cast<char>(0xBF));
+        __m128i acc = _mm_setzero_si128();
+        for (std::size_t i = 0; i < blocks; ++i, pos += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+            acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(v, last_continuation));
+        }
+        const __m128i sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+        count += static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+
+#else
+
+        const int8x16_t last_continuation = vdupq_n_s8(static_cast<std::int8_t>(0xBF));
+        uint8x16_t acc = vdupq_n_u8(0);
+        for (std::size_t i = 0; i < blocks; ++i, pos += 16) {
+            const int8x16_t v = vreinterpretq_s8_u8(vld1q_u8(src + pos));
+            acc = vsubq_u8(acc, vcgtq_s8(v, last_continuation));
+        }
+        count += vaddlvq_u8(acc);
+
+#endif
+    }
+
+#else
+
+    (void) src;
+    (void) size;
+    (void) max_count;
+    (void) count;
+
+#endif
+
+    return pos;
+}
+
+#if defined(STRF_SIMD_SSE2)
+
+inline std::uint32_t sum_epu16(__m128i x) noexcept
+{
+    x = _mm_madd_epi16(x, _mm_set1_epi16(1));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<std::uint32_t>(_mm_cvtsi128_si32(x));
+}
+
+// The lanes of `cur` moved one position up, with the last lane of
+// `prev` in the first one
+inline __m128i shift_in_last_epi16(__m128i prev, __m128i cur) noexcept
+{
+    return _mm_or_si128(_mm_slli_si128(cur, 2), _mm_srli_si128(prev, 14));
+}
+
+#endif // defined(STRF_SIMD_SSE2)
+
+// Counts the code points in blocks of eight UTF-16 code units, as
+// codepoints_fast_count does: a high surrogate and the code unit that
+// follows it are one code point. It stops before a block where a high
+// surrogate follows another one, and before `count` could reach
+// max_count. Adds the code points into `count` and returns the number
+// of code units inspected. It does nothing when sizeof(CharT) != 2.
+template <typename CharT>
+inline STRF_HD std::size_t utf16_fast_count_codepoints
+    ( const CharT* src
+    , std::size_t size
+    , std::size_t max_count
+    , std::size_t& count ) noexcept
+{
+    std::size_t pos = 0;
+
+#if defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+
+    if (sizeof(CharT) != 2) {
+        return 0;
+    }
+    const auto* units = reinterpret_cast<const std::uint16_t*>(src);
+
+#if defined(STRF_SIMD_SSE2)
+    const __m128i surrogate_bits = _mm_set1_epi16(static_cast<short>(0xFC00));
+    const __m128i high_surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+    __m128i prev_high = _mm_setzero_si128();
+#else
+    uint16x8_t prev_high = vdupq_n_u16(0);
+#endif
+
+    while (count < max_count) {
+        // Each block has at most eight code points. The 16-bit counters
+        // of each lane are incremented at most once per block.
+        std::size_t blocks = (size - pos) / 8;
+        const std::size_t max_blocks = (max_count - count - 1) / 8;
+        blocks = blocks < max_blocks ? blocks : max_blocks;
+        blocks = blocks < 0x2000 ? blocks : 0x2000;
+        if (blocks == 0) {
+            break;
+        }
+        std::size_t i = 0;
+
+#if defined(STRF_SIMD_SSE2)
+
+        __m128i acc = _mm_setzero_si128();
+        for (; i < blocks; ++i, pos += 8) {
+            const __m128i v = _mm_and_si128
+                ( _mm_loadu_si128(reinterpret_cast<const __m128i*>(units + pos))
+                , surrogate_bits );
+            const __m128i high = _mm_cmpeq_epi16(v, high_surrogate);
+            const __m128i high_after_high = _mm_and_si128
+                ( high, strf::detail::simd::shift_in_last_epi16(prev_high, high) );
+            if (_mm_movemask_epi8(high_after_high)) {
+                break;
+            }
+            acc = _mm_sub_epi16(acc, high);
+            prev_high = high;
+        }
+        count += 8 * i - strf::detail::simd::sum_epu16(acc);
+
+#else
+
+        uint16x8_t acc = vdupq_n_u16(0);
+        for (; i < blocks; ++i, pos += 8) {
+            const uint16x8_t v = vandq_u16(vld1q_u16(units + pos), vdupq_n_u16(0xFC00));
+            const uint16x8_t high = vceqq_u16(v, vdupq_n_u16(0xD800));
+            const uint16x8_t high_after_high = vandq_u16(high, vextq_u16(prev_high, high, 7));
+            if (vmaxvq_u16(high_after_high)) {
+                break;
+            }
+            acc = vsubq_u16(acc, high);
+            prev_high = high;
+        }
+        count += 8 * i - vaddvq_u16(acc);
+
+#endif
+
+        if (i != blocks) {
+            break;
+        }
+    }
+    // Up to here, each high surrogate has been counted along with the
+    // code unit that follows it, which, for the last one, is not inspected yet
+    if (pos != 0 && (units[pos - 1] & 0xFC00) == 0xD800) {
+        ++count;
+        if (pos != size) {
+            ++pos;
+        }
+    }
+
+#else
+
+    (void) src;
+    (void) size;
+    (void) max_count;
+    (void) count;
+
+#endif
+
+    return pos;
+}
+
+// Counts the code points in blocks of eight UTF-16 code units, as
+// codepoints_robust_count does: a high surrogate followed by a low
+// surrogate is one code point, and any other code unit is one code point.
+// It stops before `count` could reach max_count. Adds the code points
+// into `count` and returns the number of code units inspected.
+// It does nothing when sizeof(CharT) != 2.
+template <typename CharT>
+inline STRF_HD std::size_t utf16_robust_count_codepoints
+    ( const CharT* src
+    , std::size_t size
+    , std::size_t max_count
+    , std::size_t& count ) noexcept
+{
+    std::size_t pos = 0;
+
+#if defined(STRF_SIMD_SSE2) || defined(STRF_SIMD_NEON)
+
+    if (sizeof(CharT) != 2) {
+        return 0;
+    }
+    const auto* units = reinterpret_cast<const std::uint16_t*>(src);
+
+#if defined(STRF_SIMD_SSE2)
+    const __m128i surrogate_bits = _mm_set1_epi16(static_cast<short>(0xFC00));
+    const __m128i high_surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+    const __m128i low_surrogate = _mm_set1_epi16(static_cast<short>(0xDC00));
+    __m128i prev_high = _mm_setzero_si128();
+#else
+    uint16x8_t prev_high = vdupq_n_u16(0);
+#endif
+
+    while (count < max_count) {
+        std::size_t blocks = (size - pos) / 8;
+        const std::size_t max_blocks = (max_count - count - 1) / 8;
+        blocks = blocks < max_blocks ? blocks : max_blocks;
+        blocks = blocks < 0x2000 ? blocks : 0x2000;
+        if (blocks == 0) {
+            break;
+        }
+
+        // Counts the low surrogates that complete a surrogate pair,
+        // which are not code points by themselves
+
+#if defined(STRF_SIMD_SSE2)
+
+        __m128i acc = _mm_setzero_si128();
+        for (std::size_t i = 0; i < blocks; ++i, pos += 8) {
+            const __m128i v = _mm_and_si128
+                ( _mm_loadu_si128(reinterpret_cast<const __m128i*>(units + pos))
+                , surrogate_bits );
+            const __m128i high = _mm_cmpeq_epi16(v, high_surrogate);
+            const __m128i low = _mm_cmpeq_epi16(v, low_surrogate);
+            acc = _mm_sub_epi16
+                ( acc
+                , _mm_and_si128(low, strf::detail::simd::shift_in_last_epi16(prev_high, high)) );
+            prev_high = high;
+        }
+        count += 8 * blocks - strf::detail::simd::sum_epu16(acc);
+
+#else
+
+        uint16x8_t acc = vdupq_n_u16(0);
+        for (std::size_t i = 0; i < blocks; ++i, pos += 8) {
+            const uint16x8_t v = vandq_u16(vld1q_u16(units + pos), vdupq_n_u16(0xFC00));
+            const uint16x8_t high = vceqq_u16(v, vdupq_n_u16(0xD800));
+            const uint16x8_t low = vceqq_u16(v, vdupq_n_u16(0xDC00));
+            acc = vsubq_u16(acc, vandq_u16(low, vextq_u16(prev_high, high, 7)));
+            prev_high = high;
+        }
+        count += 8 * blocks - vaddvq_u16(acc);
+
+#endif
+    }
+    // Don't stop in the middle of a surrogate pair
+    if ( pos != 0 && pos != size
+      && (units[pos - 1] & 0xFC00) == 0xD800
+      && (units[pos] & 0xFC00) == 0xDC00 ) {
+        ++pos;
+    }
+
+#else
+
+    (void) src;
+    (void) size;
+    (void) max_count;
+    (void) count;
+
+#endif
+
+    return pos;
+}
+
+#if defined(STRF_SIMD_TARGET) && defined(STRF_SIMD_DISPATCH)
+
+inline void utf16_to_utf8_kernel
+    ( const std::uint16_t*& src
+    , const std::uint16_t* src_end
+    , std::uint8_t*& dest
+    , std::uint8_t* dest_end ) noexcept
+{
+    // Unlike src and dest, which any store through an std::uint8_t*
+    // may alias, the local copies can stay in registers
+    const auto* src_it = src;
+    auto* dest_it = dest;
+    strf::detail::simd::utf16_to_utf8(src_it, src_end, dest_it, dest_end);
+    src = src_it;
+    dest = dest_it;
+}
+
+constexpr kernels_table target_kernels() noexcept
+{
+    return { strf::detail::simd::widen_ascii<std::uint16_t>
+           , strf::detail::simd::ascii_prefix_length
+           , strf::detail::simd::utf16_to_utf8_kernel
+           , strf::detail::simd::utf8_valid_prefix_length<std::uint8_t> };
+}
+
+#endif // defined(STRF_SIMD_TARGET) && defined(STRF_SIMD_DISPATCH)
+
+#if ! defined(__CUDACC__)
+} // inline namespace STRF_SIMD_ISA
+#endif
+#if defined(STRF_SIMD_TARGET)
+} // anonymous namespace
+#endif
+
+#if defined(STRF_SIMD_DISPATCH) && defined(STRF_SOURCE)
+
+// The environment variable STRF_SIMD_KERNELS can be set to "sse2" or
+// "ssse3" to select a lower instruction set than the CPU supports,
+// which is how the tests exercise all of them.
+STRF_FUNC_IMPL const kernels_table* dispatched_kernels() noexcept
+{
+    static const kernels_table* const kernels = []() -> const kernels_table* {
+#if defined(STRF_FREESTANDING)
+        const char* limit = nullptr;
+#else
+        const char* limit = std::getenv("STRF_SIMD_KERNELS");
+#endif
+        const bool limit_sse2 = limit != nullptr && 0 == std::strcmp(limit, "sse2");
+        const bool limit_ssse3 = limit != nullptr && 0 == std::strcmp(limit, "ssse3");
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && ! limit_sse2 && ! limit_ssse3) {
+            return &strf::detail::simd::avx2_kernels;
+        }
+        if (__builtin_cpu_supports("ssse3") && ! limit_sse2) {
+            return &strf::detail::simd::ssse3_kernels;
+        }
+        return nullptr;
+    } ();
+    return kernels;
+}
+
+#endif // defined(STRF_SIMD_DISPATCH) && defined(STRF_SOURCE)
+
+} // namespace simd
+} // namespace detail
+} // namespace strf
+
+#endif  // STRF_DETAIL_SIMD_HPP
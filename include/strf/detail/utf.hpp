@@ -7,6 +7,15 @@
 
 #include <strf/detail/facets/char_encoding.hpp>
 #include <strf/detail/standard_lib_functions.hpp>
+#include <strf/detail/simd.hpp>
+
+#if defined(STRF_SIMD_TARGET)
+// The transcoders are not tagged with the instruction set, so a
+// translation unit compiled for a higher one would emit, under the same
+// names, versions of them that the other translation units may end up
+// calling on CPUs that don't support it.
+#error "<strf/detail/utf.hpp> must not be included where STRF_SIMD_TARGET is defined"
+#endif
 
 namespace strf {
 
@@ -352,6 +361,22 @@ public:
     {
         return transcode_size;
     }
+
+private:
+
+    static STRF_HD void transcode_simd_
+        ( strf::basic_outbuff<DestCharT>& ob
+        , const SrcCharT* src
+        , std::size_t src_size
+        , strf::invalid_seq_notifier inv_seq_notifier
+        , strf::surrogate_policy surr_poli );
+
+    static STRF_HD void transcode_scalar_
+        ( strf::basic_outbuff<DestCharT>& ob
+        , const SrcCharT* src
+        , std::size_t src_size
+        , strf::invalid_seq_notifier inv_seq_notifier
+        , strf::surrogate_policy surr_poli );
 };
 
 template <typename SrcCharT, typename DestCharT>
@@ -1152,7 +1177,43 @@ STRF_HD void strf::static_transcoder
     auto src_end = src + src_size;
     auto dest_it = ob.pointer();
     auto dest_end = ob.end();
+    unsigned scalar_count = 0;
+    unsigned scalar_stretch = 16;
     while(src_it != src_end) {
+        if (scalar_count == 0) {
+            // Copy the valid content as it is. The scalar path is only
+            // used around invalid sequences, for a stretch that grows
+            // while the vectorized validation fails to make progress.
+            auto count = strf::detail::simd::utf8_valid_prefix_length(src_it, src_end - src_it);
+            scalar_stretch = count >= 16 ? 16
+                : scalar_stretch < 256 ? 2 * scalar_stretch : 256;
+            scalar_count = scalar_stretch;
+            while (count != 0) {
+                const std::size_t space = dest_end - dest_it;
+                const std::size_t n = count <= space ? count : space -
+                    strf::detail::simd::utf8_incomplete_tail
+                        ( reinterpret_cast<const std::uint8_t*>(src_it), space );
+                if (n == 0) {
+                    // As in the scalar path, don't split a multi-byte sequence
+                    ob.advance_to(dest_it);
+                    ob.recycle();
+                    if (!ob.good()) {
+                        return;
+                    }
+                    dest_it = ob.pointer();
+                    dest_end = ob.end();
+                    continue;
+                }
+                strf::detail::copy_n(src_it, n, dest_it);
+                src_it += n;
+                dest_it += n;
+                count -= n;
+            }
+            if (src_it == src_end) {
+                break;
+            }
+        }
+        --scalar_count;
         ch0 = (*src_it);
         ++src_it;
         if(ch0 < 0x80) {
@@ -1236,7 +1297,21 @@ STRF_HD std::size_t strf::static_transcoder
     const SrcCharT* src_it = src;
     auto src_end = src + src_size;
     std::size_t size = 0;
+    unsigned scalar_count = 0;
+    unsigned scalar_stretch = 16;
     while(src_it != src_end) {
+        if (scalar_count == 0) {
+            const auto count = strf::detail::simd::utf8_valid_prefix_length(src_it, src_end - src_it);
+            scalar_stretch = count >= 16 ? 16
+                : scalar_stretch < 256 ? 2 * scalar_stretch : 256;
+            scalar_count = scalar_stretch;
+            src_it += count;
+            size += count;
+            if (src_it == src_end) {
+                break;
+            }
+        }
+        --scalar_count;
         ch0 = *src_it;
         ++src_it;
         if(ch0 < 0x80) {
@@ -1288,7 +1363,8 @@ static_char_encoding<CharT, strf::eid_utf8>::codepoints_fast_count
     , std::size_t max_count ) noexcept
 {
     std::size_t count = 0;
-    auto it = src;
+    auto it = src + strf::detail::simd::utf8_count_codepoints
+        ( reinterpret_cast<const std::uint8_t*>(src), src_size, max_count, count );
     auto end = src + src_size;
     while (it != end && count < max_count) {
         if (!strf::detail::is_utf8_continuation(*it)) {
@@ -1296,6 +1372,10 @@ static_char_encoding<CharT, strf::eid_utf8>::codepoints_fast_count
         }
         ++it;
     }
+    // Don't stop in the middle of the last code point
+    while (it != end && strf::detail::is_utf8_continuation(*it)) {
+        ++it;
+    }
     return {count, static_cast<std::size_t>(it - src)};
 }
 
@@ -1316,6 +1396,21 @@ static_char_encoding<CharT, strf::eid_utf8>::codepoints_robust_count
     std::size_t count = 0;
     auto it = src;
     auto end = src + src_size;
+    if (max_count != 0) {
+        // Each code point takes at most four bytes, so there is no need
+        // to validate beyond that
+        const std::size_t max_size = max_count < src_size / 4 ? 4 * max_count : src_size;
+        const auto valid_size = strf::detail::simd::utf8_valid_prefix_length(src, max_size);
+        const auto* const src_u8 = reinterpret_cast<const std::uint8_t*>(src);
+        const auto pos = strf::detail::simd::utf8_count_codepoints
+            ( src_u8, valid_size, max_count, count );
+        // Don't stop in the middle of a multi-byte sequence
+        const auto tail = strf::detail::simd::utf8_incomplete_tail(src_u8, pos);
+        if (tail != 0) {
+            -- count;
+        }
+        it += pos - tail;
+    }
     while (it != end && count != max_count) {
         ch0 = (*it);
         ++it;
@@ -1666,10 +1761,11 @@ static_char_encoding<CharT, strf::eid_utf16>::codepoints_fast_count
     , std::size_t max_count ) noexcept
 {
     std::size_t count = 0;
-    auto it = src;
+    auto it = src + strf::detail::simd::utf16_fast_count_codepoints
+        ( src, src_size, max_count, count );
     const auto end = src + src_size;
     while(it != end && count < max_count) {
-        if(strf::detail::is_high_surrogate(*it)) {
+        if(strf::detail::is_high_surrogate(*it) && end - it > 1) {
             ++it;
         }
         ++it;
@@ -1688,7 +1784,8 @@ static_char_encoding<CharT, strf::eid_utf16>::codepoints_robust_count
 {
     (void) surr_poli;
     std::size_t count = 0;
-    const CharT* it = src;
+    const CharT* it = src + strf::detail::simd::utf16_robust_count_codepoints
+        ( src, src_size, max_count, count );
     const auto end = src + src_size;
     unsigned long ch;
     while (it != end && count < max_count) {
@@ -1698,7 +1795,6 @@ static_char_encoding<CharT, strf::eid_utf16>::codepoints_robust_count
         if ( strf::detail::is_high_surrogate(ch) && it != end
           && strf::detail::is_low_surrogate(*it)) {
             ++ it;
-            ++ count;
         }
     }
     return {count, static_cast<std::size_t>(it - src)};
@@ -1905,6 +2001,17 @@ STRF_HD void strf::static_transcoder
         if (ch0 < 0x80) {
             STRF_CHECK_DEST;
             *dest_it = ch0;
+            if ( src_end - src_it >= 16
+              && strf::detail::simd::is_ascii_word(reinterpret_cast<const std::uint8_t*>(src_it)) ) {
+                const std::size_t src_left = src_end - src_it;
+                const std::size_t dest_left = dest_end - dest_it - 1;
+                const auto count = strf::detail::simd::widen_ascii
+                    ( reinterpret_cast<const std::uint8_t*>(src_it)
+                    , src_left < dest_left ? src_left : dest_left
+                    , dest_it + 1 );
+                src_it += count;
+                dest_it += count;
+            }
         } else if (0xC0 == (ch0 & 0xE0)) {
             if ( ch0 > 0xC1
               && src_it != src_end && is_utf8_continuation(ch1 = * src_it))
@@ -1978,7 +2085,13 @@ STRF_HD std::size_t strf::static_transcoder
         ch0 = *src_it;
         ++src_it;
         ++size;
-        if (0xC0 == (ch0 & 0xE0)) {
+        if ( ch0 < 0x80 && src_end - src_it >= 16
+          && strf::detail::simd::is_ascii_word(reinterpret_cast<const std::uint8_t*>(src_it)) ) {
+            const auto count = strf::detail::simd::ascii_prefix_length
+                ( reinterpret_cast<const std::uint8_t*>(src_it), src_end - src_it );
+            src_it += count;
+            size += count;
+        } else if (0xC0 == (ch0 & 0xE0)) {
             if (ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(*src_it)) {
                 ++src_it;
             }
@@ -2018,6 +2131,64 @@ STRF_HD void strf::static_transcoder
     , std::size_t src_size
     , strf::invalid_seq_notifier inv_seq_notifier
     , strf::surrogate_policy surr_poli )
+{
+    // Short inputs only use the scalar path
+    if (src_size < 64) {
+        transcode_scalar_(ob, src, src_size, inv_seq_notifier, surr_poli);
+    } else {
+        transcode_simd_(ob, src, src_size, inv_seq_notifier, surr_poli);
+    }
+}
+
+template <typename SrcCharT, typename DestCharT>
+STRF_HD void strf::static_transcoder
+    < SrcCharT, DestCharT, strf::eid_utf16, strf::eid_utf8 >::transcode_simd_
+    ( strf::basic_outbuff<DestCharT>& ob
+    , const SrcCharT* src
+    , std::size_t src_size
+    , strf::invalid_seq_notifier inv_seq_notifier
+    , strf::surrogate_policy surr_poli )
+{
+    // The vectorized path is tried between stretches of the scalar one,
+    // when the next block only has the kinds of code units it handles.
+    // A stretch is short while the vectorized path makes progress, and
+    // it grows each time it doesn't.
+    auto src_it = src;
+    const auto src_end = src + src_size;
+    std::ptrdiff_t stretch = 64;
+    while (true) {
+        const auto* const previous_src_it = src_it;
+        if ( src_end - src_it >= 8
+          && strf::detail::simd::utf16_to_utf8_accepts(src_it) ) {
+            auto dest_it = ob.pointer();
+            strf::detail::simd::utf16_to_utf8(src_it, src_end, dest_it, ob.end());
+            ob.advance_to(dest_it);
+            if (src_it == src_end) {
+                return;
+            }
+        }
+        stretch = src_it - previous_src_it >= 16 ? 16
+            : stretch < 512 ? 8 * stretch : 4096;
+        auto stretch_end = src_end - src_it > stretch ? src_it + stretch : src_end;
+        if (stretch_end != src_end && strf::detail::is_high_surrogate(stretch_end[-1])) {
+            ++stretch_end; // don't split a surrogate pair
+        }
+        transcode_scalar_(ob, src_it, stretch_end - src_it, inv_seq_notifier, surr_poli);
+        if (stretch_end == src_end || ! ob.good()) {
+            return;
+        }
+        src_it = stretch_end;
+    }
+}
+
+template <typename SrcCharT, typename DestCharT>
+STRF_HD void strf::static_transcoder
+    < SrcCharT, DestCharT, strf::eid_utf16, strf::eid_utf8 >::transcode_scalar_
+    ( strf::basic_outbuff<DestCharT>& ob
+    , const SrcCharT* src
+    , std::size_t src_size
+    , strf::invalid_seq_notifier inv_seq_notifier
+    , strf::surrogate_policy surr_poli )
 {
     (void) inv_seq_notifier;
     auto src_it = src;
@@ -2044,7 +2215,7 @@ STRF_HD void strf::static_transcoder
             dest_it[2] = static_cast<DestCharT>(0x80 |  (ch &   0x3F));
             dest_it += 3;
         } else if ( strf::detail::is_high_surrogate(ch)
-               && src_it != src_end
+               && src_it + 1 != src_end
                && strf::detail::is_low_surrogate(*(src_it + 1)))
         {
             STRF_CHECK_DEST_SIZE(4);
@@ -2081,8 +2252,10 @@ STRF_HD std::size_t strf::static_transcoder
 {
     (void) surr_poli;
     const auto src_end = src + src_size;
-    std::size_t size = 0;
-    for(auto it = src; it < src_end; ++it) {
+    auto it = src;
+    // The vectorized path counts all but the last few code units
+    std::size_t size = strf::detail::simd::utf16_to_utf8_size(it, src_end);
+    for(; it < src_end; ++it) {
         SrcCharT ch = *it;
         if (ch < 0x80) {
             ++size;
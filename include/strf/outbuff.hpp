@@ -66,6 +66,10 @@ public:
     {
         return good_;
     }
+    STRF_HD bool can_borrow() const noexcept
+    {
+        return can_borrow_;
+    }
     STRF_HD void advance_to(char_type* p)
     {
         STRF_ASSERT(pointer_ <= p);
@@ -97,6 +101,20 @@ public:
 
     STRF_HD virtual void recycle() = 0;
 
+    // Offers the outbuff to keep a reference to [str, str + len)
+    // instead of having these characters copied into the buffer.
+    // If it returns true, the characters are considered written,
+    // and the caller must not write them. In this case, str must
+    // remain valid until the outbuff is finished.
+    // Only called when can_borrow() returns true, so that outbuffs
+    // that never borrow don't pay for a virtual function call.
+    STRF_HD virtual bool borrow(const char_type* str, std::size_t len)
+    {
+        (void) str;
+        (void) len;
+        return false;
+    }
+
 protected:
 
     STRF_HD basic_outbuff(char_type* p, char_type* e) noexcept
@@ -113,12 +131,15 @@ protected:
     { end_ = e; };
     STRF_HD void set_good(bool g) noexcept
     { good_ = g; };
+    STRF_HD void set_can_borrow(bool b) noexcept
+    { can_borrow_ = b; };
 
 private:
 
     char_type* pointer_;
     char_type* end_;
     bool good_ = true;
+    bool can_borrow_ = false;
     friend class strf::detail::outbuff_test_tool;
 };
 
@@ -221,11 +242,31 @@ public:
 
 } // namespace detail
 
+namespace detail {
+
+// Occupies whole cache lines, so that writing into the garbage buffer
+// doesn't invalidate the cache lines of unrelated objects.
+template <typename CharT>
+struct alignas(64) outbuff_garbage_buf_storage
+{
+    CharT arr[ STRF_MIN_SPACE_AFTER_RECYCLE ];
+};
+
+} // namespace detail
+
+// Each thread has its own garbage buffer, so that outbuffs in "bad"
+// state in different threads don't keep writing into the same cache line.
+// Hence outbuffs shall not detect the "bad" state by comparing pointer()
+// or end() with the garbage buffer, and recycle() shall always set both.
 template <typename CharT>
 inline STRF_HD CharT* outbuff_garbage_buf() noexcept
 {
-    static CharT arr[ STRF_MIN_SPACE_AFTER_RECYCLE ];
-    return arr;
+#if defined(__CUDA_ARCH__) || defined(STRF_FREESTANDING)
+    static strf::detail::outbuff_garbage_buf_storage<CharT> storage;
+#else
+    static thread_local strf::detail::outbuff_garbage_buf_storage<CharT> storage;
+#endif
+    return storage.arr;
 }
 
 template <typename CharT>
@@ -274,9 +315,9 @@ public:
         if (this->good()) {
             it_ = this->pointer();
             this->set_good(false);
-            this->set_end(outbuff_garbage_buf_end<CharT>());
         }
         this->set_pointer(outbuff_garbage_buf<CharT>());
+        this->set_end(outbuff_garbage_buf_end<CharT>());
     }
 
     struct result
@@ -314,6 +355,106 @@ using u16cstr_writer = basic_cstr_writer<char16_t>;
 using u32cstr_writer = basic_cstr_writer<char32_t>;
 using wcstr_writer = basic_cstr_writer<wchar_t>;
 
+// Like basic_cstr_writer, but after the destination is full, it keeps
+// counting the characters that would have been written, so that finish()
+// can tell the size of the destination that would be needed, like
+// snprintf does. Until finish() is called, good() remains true, so that
+// printers do not stop writing.
+template <typename CharT>
+class basic_cstr_counting_writer final: public strf::basic_outbuff_noexcept<CharT>
+{
+public:
+
+    struct range{ CharT* dest; CharT* dest_end; };
+
+    STRF_HD basic_cstr_counting_writer(range r) noexcept
+        : basic_outbuff_noexcept<CharT>(r.dest, r.dest_end - 1)
+        , dest_(r.dest)
+    {
+        STRF_ASSERT(r.dest < r.dest_end);
+    }
+
+    STRF_HD basic_cstr_counting_writer(CharT* dest, CharT* dest_end) noexcept
+        : basic_outbuff_noexcept<CharT>(dest, dest_end - 1)
+        , dest_(dest)
+    {
+        STRF_ASSERT(dest < dest_end);
+    }
+
+    STRF_HD basic_cstr_counting_writer(CharT* dest, std::size_t len) noexcept
+        : basic_outbuff_noexcept<CharT>(dest, dest + len - 1)
+        , dest_(dest)
+    {
+        STRF_ASSERT(len != 0);
+    }
+
+    template <std::size_t N>
+    STRF_HD basic_cstr_counting_writer(CharT (&dest)[N]) noexcept
+        : basic_outbuff_noexcept<CharT>(dest, dest + N - 1)
+        , dest_(dest)
+    {
+    }
+
+    basic_cstr_counting_writer(const basic_cstr_counting_writer&) = delete;
+
+    STRF_HD void recycle() noexcept override
+    {
+        if (it_ == nullptr) {
+            it_ = this->pointer();
+        } else {
+            discarded_ += garbage_written_();
+        }
+        this->set_pointer(outbuff_garbage_buf<CharT>());
+        this->set_end(outbuff_garbage_buf_end<CharT>());
+    }
+
+    struct result
+    {
+        CharT* ptr;
+        bool truncated;
+        std::size_t required_size; // not counting the termination character
+    };
+
+    STRF_HD result finish() noexcept
+    {
+        bool truncated = ! this->good() || it_ != nullptr;
+        if (it_ == nullptr) {
+            it_ = this->pointer();
+        } else {
+            discarded_ += garbage_written_();
+        }
+        this->set_good(false);
+        this->set_pointer(outbuff_garbage_buf<CharT>());
+        this->set_end(outbuff_garbage_buf_end<CharT>());
+
+        *it_ = CharT();
+
+        return { it_, truncated, (std::size_t)(it_ - dest_) + discarded_ };
+    }
+
+private:
+
+    // end() may point to the garbage buffer of another thread, where
+    // recycle() was called. So count from end(), not outbuff_garbage_buf().
+    STRF_HD std::size_t garbage_written_() const noexcept
+    {
+        auto garbage_begin = this->end() - strf::min_space_after_recycle<CharT>();
+        return this->pointer() - garbage_begin;
+    }
+
+    CharT* dest_;
+    CharT* it_ = nullptr;
+    std::size_t discarded_ = 0;
+};
+
+#if defined(__cpp_char8_t)
+using u8cstr_counting_writer = basic_cstr_counting_writer<char8_t>;
+#endif
+using cstr_counting_writer = basic_cstr_counting_writer<char>;
+using u16cstr_counting_writer = basic_cstr_counting_writer<char16_t>;
+using u32cstr_counting_writer = basic_cstr_counting_writer<char32_t>;
+using wcstr_counting_writer = basic_cstr_counting_writer<wchar_t>;
+
 template <typename CharT>
 class discarded_outbuff final
     : public strf::basic_outbuff_noexcept<CharT>
@@ -335,6 +476,7 @@ public:
     STRF_HD void recycle() noexcept override
     {
         this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
     }
 };
 
@@ -30,6 +30,26 @@ inline STRF_HD void outbuff_interchar_copy
     } while(ob.good());
 }
 
+// Used by printers of strings that could be large. Instead of copying,
+// gives the outbuff the chance to just keep a reference to the string.
+template <typename CharT>
+inline STRF_HD void outbuff_borrow_or_copy
+    ( strf::basic_outbuff<CharT>& ob, const CharT* str, std::size_t len )
+{
+    if ( len <= strf::min_space_after_recycle<CharT>()
+      || ! ob.can_borrow()
+      || ! ob.borrow(str, len) ) {
+        strf::detail::outbuff_interchar_copy(ob, str, len);
+    }
+}
+
+template <typename DestCharT, typename SrcCharT>
+inline STRF_HD void outbuff_borrow_or_copy
+    ( strf::basic_outbuff<DestCharT>& ob, const SrcCharT* str, std::size_t len )
+{
+    strf::detail::outbuff_interchar_copy(ob, str, len);
+}
+
 } // namespace detail
 
 template <typename CharT>
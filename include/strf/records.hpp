@@ -0,0 +1,280 @@
+#ifndef STRF_RECORDS_HPP
+#define STRF_RECORDS_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <tuple>
+#include <iterator>
+#include <initializer_list>
+
+namespace strf {
+
+// The range is traversed twice: once to calculate the size and width
+// and once to print. Hence the iterator must be a forward iterator, and
+// the layout ( or the generator ) must return equivalent records each
+// time it is called with the same element.
+template <typename It, typename Layout>
+struct records_p
+{
+    static_assert
+        ( std::is_base_of
+            < std::forward_iterator_tag
+            , typename std::iterator_traits<It>::iterator_category >::value
+        , "strf::records requires a forward iterator, since it reads the records twice" );
+
+    using iterator = It;
+
+    It begin;
+    It end;
+    Layout layout;
+};
+
+namespace detail {
+
+struct records_identity_layout
+{
+    template <typename T>
+    constexpr STRF_HD const T& operator()(const T& x) const noexcept
+    {
+        return x;
+    }
+};
+
+// Iterates over [0, count), yielding gen(i)
+template <typename Generator>
+class records_generator_iterator
+{
+public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_cv_t<std::remove_reference_t
+        < decltype(std::declval<const Generator&>()(std::size_t{})) >>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = decltype(std::declval<const Generator&>()(std::size_t{}));
+
+    constexpr STRF_HD records_generator_iterator
+        ( const Generator& gen, std::size_t index )
+        : gen_(gen)
+        , index_(index)
+    {
+    }
+
+    STRF_HD decltype(auto) operator*() const
+    {
+        return gen_(index_);
+    }
+    STRF_HD records_generator_iterator& operator++() noexcept
+    {
+        ++index_;
+        return *this;
+    }
+    constexpr STRF_HD bool operator==(const records_generator_iterator& other) const noexcept
+    {
+        return index_ == other.index_;
+    }
+    constexpr STRF_HD bool operator!=(const records_generator_iterator& other) const noexcept
+    {
+        return index_ != other.index_;
+    }
+
+private:
+
+    Generator gen_;
+    std::size_t index_;
+};
+
+template <typename CharT, typename FPack, typename It, typename Layout>
+class records_printer;
+
+} // namespace detail
+
+template <typename It, typename Layout>
+struct print_traits<strf::records_p<It, Layout>>
+{
+    using forwarded_type = strf::records_p<It, Layout>;
+
+    template <typename CharT, typename Preview, typename FPack>
+    STRF_HD constexpr static auto make_printer_input
+        (Preview& preview, const FPack& fp,  forwarded_type x)
+        -> strf::usual_printer_input
+            < CharT, Preview, FPack, forwarded_type
+            , strf::detail::records_printer<CharT, FPack, It, Layout> >
+    {
+        return {preview, fp, x};
+    }
+};
+
+namespace detail {
+
+// Prints all the records within a single printer, so that the destination
+// is created once for the whole batch. The printers of the fields, though,
+// are created for each record, and twice when Preview requires the size
+// or the width: once in preview_record_ and once in print_record_.
+template <typename CharT, typename FPack, typename It, typename Layout>
+class records_printer: public strf::printer<CharT>
+{
+public:
+
+    template <typename... T>
+    STRF_HD records_printer(const strf::usual_printer_input<T...>& input)
+        : fp_(input.facets)
+        , begin_(input.arg.begin)
+        , end_(input.arg.end)
+        , layout_(input.arg.layout)
+    {
+        preview_(input.preview);
+    }
+
+    STRF_HD void print_to(strf::basic_outbuff<CharT>& ob) const override;
+
+private:
+
+    using record_type_ = std::remove_cv_t<std::remove_reference_t
+        < decltype(std::declval<const Layout&>()(*std::declval<const It&>())) >>;
+
+    using fields_indexes_ = std::make_index_sequence
+        < std::tuple_size<record_type_>::value >;
+
+    template <typename Preview, std::size_t I>
+    using field_printer_ = strf::printer_type
+        < CharT, Preview, FPack
+        , std::remove_cv_t<std::remove_reference_t
+            < std::tuple_element_t<I, record_type_> >> >;
+
+    STRF_HD void preview_(strf::no_print_preview&) const
+    {
+    }
+
+    template < typename Preview
+             , std::enable_if_t<Preview::something_required, int> = 0 >
+    STRF_HD void preview_(Preview& preview) const;
+
+    template <typename Preview, std::size_t ... I>
+    STRF_HD void preview_record_
+        ( Preview& preview
+        , const record_type_& rec
+        , std::index_sequence<I...> ) const;
+
+    template <std::size_t ... I>
+    STRF_HD void print_record_
+        ( strf::basic_outbuff<CharT>& ob
+        , const record_type_& rec
+        , std::index_sequence<I...> ) const;
+
+    const FPack& fp_;
+    It begin_;
+    It end_;
+    Layout layout_;
+};
+
+template <typename CharT, typename FPack, typename It, typename Layout>
+template < typename Preview
+         , std::enable_if_t<Preview::something_required, int> >
+STRF_HD void records_printer<CharT, FPack, It, Layout>::preview_(Preview& preview) const
+{
+    for(auto it = begin_; it != end_; ++it) {
+        preview_record_(preview, layout_(*it), fields_indexes_{});
+    }
+}
+
+template <typename CharT, typename FPack, typename It, typename Layout>
+template <typename Preview, std::size_t ... I>
+STRF_HD void records_printer<CharT, FPack, It, Layout>::preview_record_
+    ( Preview& preview
+    , const record_type_& rec
+    , std::index_sequence<I...> ) const
+{
+    (void) rec;
+    using swallow_ = int[];
+    (void) swallow_
+        { 0
+        , ( (void) field_printer_<Preview, I>
+              ( strf::make_printer_input<CharT>(preview, fp_, std::get<I>(rec)) )
+          , 0 )... };
+}
+
+template <typename CharT, typename FPack, typename It, typename Layout>
+STRF_HD void records_printer<CharT, FPack, It, Layout>::print_to
+    ( strf::basic_outbuff<CharT>& ob ) const
+{
+    for(auto it = begin_; it != end_; ++it) {
+        print_record_(ob, layout_(*it), fields_indexes_{});
+    }
+}
+
+template <typename CharT, typename FPack, typename It, typename Layout>
+template <std::size_t ... I>
+STRF_HD void records_printer<CharT, FPack, It, Layout>::print_record_
+    ( strf::basic_outbuff<CharT>& ob
+    , const record_type_& rec
+    , std::index_sequence<I...> ) const
+{
+    (void) rec;
+    strf::no_print_preview no_preview;
+    (void) no_preview;
+    using swallow_ = int[];
+    (void) swallow_
+        { 0
+        , ( field_printer_<strf::no_print_preview, I>
+                ( strf::make_printer_input<CharT>(no_preview, fp_, std::get<I>(rec)) )
+              .print_to(ob)
+          , 0 )... };
+}
+
+} // namespace detail
+
+template < typename It
+         , typename Layout = strf::detail::records_identity_layout
+         , typename = decltype(std::declval<const Layout&>()(*std::declval<const It&>())) >
+inline STRF_HD auto records(It begin, It end, Layout layout = Layout{})
+{
+    return strf::records_p<It, Layout>{begin, end, layout};
+}
+
+template < typename Range
+         , typename Layout = strf::detail::records_identity_layout
+         , typename It = typename Range::const_iterator
+         , typename = decltype(std::declval<const Layout&>()(*std::declval<const It&>()))
+         , typename = decltype(std::declval<const Range&>().begin())
+         , typename = decltype(std::declval<const Range&>().end()) >
+inline STRF_HD auto records(const Range& r, Layout layout = Layout{})
+{
+    return strf::records_p<It, Layout>{r.begin(), r.end(), layout};
+}
+
+template < typename T
+         , typename Layout = strf::detail::records_identity_layout
+         , typename = decltype(std::declval<const Layout&>()(std::declval<const T&>())) >
+inline STRF_HD auto records(std::initializer_list<T> r, Layout layout = Layout{})
+{
+    return strf::records_p<const T*, Layout>{r.begin(), r.end(), layout};
+}
+
+template < typename T
+         , std::size_t N
+         , typename Layout = strf::detail::records_identity_layout
+         , typename = decltype(std::declval<const Layout&>()(std::declval<const T&>())) >
+inline STRF_HD auto records(T (&array)[N], Layout layout = Layout{})
+{
+    return strf::records_p<const T*, Layout>{&array[0], &array[0] + N, layout};
+}
+
+// The records are gen(0), gen(1), ..., gen(count - 1) . gen is called
+// twice for each index, so it must not have side effects.
+template < typename Generator
+         , typename Layout = strf::detail::records_identity_layout
+         , typename = decltype(std::declval<const Generator&>()(std::size_t{}))
+         , typename It = strf::detail::records_generator_iterator<Generator>
+         , typename = decltype(std::declval<const Layout&>()(*std::declval<const It&>())) >
+inline STRF_HD auto records(std::size_t count, Generator gen, Layout layout = Layout{})
+{
+    return strf::records_p<It, Layout>{It{gen, 0}, It{gen, count}, layout};
+}
+
+} // namespace strf
+
+#endif  // STRF_RECORDS_HPP
@@ -0,0 +1,273 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_ARENA_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_ARENA_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace strf {
+
+// A monotonic bump allocator. Memory is obtained in blocks and is
+// only given back in reset() and in the destructor.
+class arena
+{
+public:
+
+    static constexpr std::size_t default_block_size = 4096;
+
+    explicit arena(std::size_t block_size = default_block_size) noexcept
+        : block_size_(block_size)
+    {
+    }
+
+    arena(const arena&) = delete;
+    arena(arena&&) = delete;
+
+    ~arena()
+    {
+        release_blocks_(nullptr);
+    }
+
+    void* allocate
+        ( std::size_t size
+        , std::size_t alignment = alignof(std::max_align_t) )
+    {
+        char* p = align(alignment);
+        if (p == nullptr || static_cast<std::size_t>(limit_ - p) < size) {
+            new_block(size + alignment);
+            p = align(alignment);
+        }
+        cursor_ = p + size;
+        return p;
+    }
+
+    // Deallocates all blocks but the current one, which is reused.
+    void reset() noexcept
+    {
+        if (blocks_ != nullptr) {
+            release_blocks_(blocks_);
+            blocks_->next = nullptr;
+            cursor_ = blocks_->data();
+        }
+    }
+
+    // The functions below are used by basic_arena_writer to write
+    // directly into the free space of the current block.
+
+    char* align(std::size_t alignment) noexcept
+    {
+        if (cursor_ == nullptr) {
+            return nullptr;
+        }
+        auto addr = reinterpret_cast<std::uintptr_t>(cursor_);
+        auto aligned = (addr + alignment - 1) & ~(alignment - 1);
+        if (aligned > reinterpret_cast<std::uintptr_t>(limit_)) {
+            return limit_;
+        }
+        return cursor_ + (aligned - addr);
+    }
+
+    char* limit() const noexcept
+    {
+        return limit_;
+    }
+
+    void set_cursor(char* p) noexcept
+    {
+        STRF_ASSERT(blocks_ != nullptr && blocks_->data() <= p && p <= limit_);
+        cursor_ = p;
+    }
+
+    // Makes the free space of the current block unusable, and moves
+    // to a new block of at least min_size bytes.
+    void new_block(std::size_t min_size)
+    {
+        std::size_t size = min_size < block_size_ ? block_size_ : min_size;
+        void* mem = ::operator new(sizeof(block_header_) + size);
+        auto* b = new (mem) block_header_{blocks_, size};
+        blocks_ = b;
+        cursor_ = b->data();
+        limit_ = cursor_ + size;
+    }
+
+private:
+
+    struct alignas(std::max_align_t) block_header_
+    {
+        block_header_* next;
+        std::size_t size;
+
+        char* data() noexcept
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    void release_blocks_(block_header_* keep) noexcept
+    {
+        block_header_* b = keep == nullptr ? blocks_ : keep->next;
+        while (b != nullptr) {
+            block_header_* next = b->next;
+            ::operator delete(b);
+            b = next;
+        }
+    }
+
+    std::size_t block_size_;
+    block_header_* blocks_ = nullptr;
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+};
+
+// Writes into the free space of the current block of an arena. When
+// the block is full, the content is moved to a new block, so that the
+// result is always contiguous. finish() returns a string view to the
+// arena memory, which remains valid until the arena is reset or
+// destroyed.
+template <typename CharT>
+class basic_arena_writer final: public strf::basic_outbuff<CharT>
+{
+public:
+
+#if defined(STRF_HAS_STD_STRING_VIEW)
+    using result = std::basic_string_view<CharT>;
+#else
+    using result = strf::detail::simple_string_view<CharT>;
+#endif
+
+    struct settings
+    {
+        strf::arena* arena;
+        std::size_t capacity;
+    };
+
+    explicit basic_arena_writer(settings s)
+        : strf::basic_outbuff<CharT>(nullptr, nullptr)
+        , arena_(*s.arena)
+    {
+        constexpr std::size_t min_size = strf::min_space_after_recycle<CharT>();
+        auto capacity = s.capacity < min_size ? min_size : s.capacity;
+        char* p = arena_.align(alignof(CharT));
+        if (p == nullptr || static_cast<std::size_t>(arena_.limit() - p) < capacity * sizeof(CharT)) {
+            arena_.new_block(capacity * sizeof(CharT));
+            p = arena_.align(alignof(CharT));
+        }
+        begin_ = reinterpret_cast<CharT*>(p);
+        this->set_pointer(begin_);
+        this->set_end(begin_ + (arena_.limit() - p) / sizeof(CharT));
+    }
+
+    explicit basic_arena_writer(strf::arena& a, std::size_t capacity = 0)
+        : basic_arena_writer(settings{&a, capacity})
+    {
+    }
+
+    basic_arena_writer(const basic_arena_writer&) = delete;
+    basic_arena_writer(basic_arena_writer&&) = delete;
+
+    void recycle() override
+    {
+        if (this->good()) {
+            std::size_t len = this->pointer() - begin_;
+            std::size_t growth = len < strf::min_space_after_recycle<CharT>()
+                ? strf::min_space_after_recycle<CharT>()
+                : len;
+            const CharT* old_begin = begin_;
+            this->set_good(false);
+            arena_.new_block((len + growth) * sizeof(CharT) + alignof(CharT));
+            char* p = arena_.align(alignof(CharT));
+            begin_ = reinterpret_cast<CharT*>(p);
+            strf::detail::copy_n(old_begin, len, begin_);
+            this->set_good(true);
+            this->set_pointer(begin_ + len);
+            this->set_end(begin_ + (arena_.limit() - p) / sizeof(CharT));
+        } else {
+            discard_unused_();
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        }
+    }
+
+    result finish()
+    {
+        discard_unused_();
+        arena_.set_cursor(reinterpret_cast<char*>(begin_ + len_));
+        this->set_good(false);
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        return {begin_, len_};
+    }
+
+private:
+
+    void discard_unused_()
+    {
+        if ( ! discarding_) {
+            len_ = this->pointer() - begin_;
+            discarding_ = true;
+        }
+    }
+
+    strf::arena& arena_;
+    CharT* begin_ = nullptr;
+    std::size_t len_ = 0;
+    bool discarding_ = false; // whether no longer writing into the arena
+};
+
+using arena_writer = basic_arena_writer<char>;
+using u16arena_writer = basic_arena_writer<char16_t>;
+using u32arena_writer = basic_arena_writer<char32_t>;
+using warena_writer = basic_arena_writer<wchar_t>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_arena_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_arena_writer<CharT>;
+    using sized_outbuff_type = outbuff_type;
+    using finish_type = typename outbuff_type::result;
+
+    constexpr explicit basic_arena_writer_creator(strf::arena& a) noexcept
+        : arena_(&a)
+    {
+    }
+
+    constexpr basic_arena_writer_creator
+        (const basic_arena_writer_creator&) = default;
+
+    typename outbuff_type::settings create() const noexcept
+    {
+        return {arena_, 0};
+    }
+    typename outbuff_type::settings create(std::size_t size) const noexcept
+    {
+        return {arena_, size};
+    }
+
+private:
+
+    strf::arena* arena_;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_arena(strf::arena& a)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_arena_writer_creator<CharT> >
+        (a);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_ARENA_HPP
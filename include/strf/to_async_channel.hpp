@@ -0,0 +1,371 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_ASYNC_CHANNEL_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_ASYNC_CHANNEL_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#  define STRF_HAS_COROUTINES
+#endif
+#endif
+
+#if defined(STRF_HAS_COROUTINES)
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+namespace strf {
+
+namespace detail {
+
+template <typename CharT>
+class async_pending_write
+{
+public:
+
+    // Writes as much as possible without exceeding the free space
+    // of the channel. Returns true when everything has been written.
+    virtual bool resume_writing() noexcept = 0;
+
+protected:
+
+    ~async_pending_write() = default;
+};
+
+} // namespace detail
+
+// A bounded buffer between a producer coroutine, that writes into it
+// through strf::async_to, and a consumer coroutine, that reads it with
+// wait_for_data(), data(), size() and consume(). Both run in the same
+// thread. When there is not enough space for the next argument, the
+// producer suspends and the control is transferred to the consumer.
+//
+// recycle() can not suspend, since it is called from inside the
+// printers. So a producer only suspends between two arguments, and
+// the buffer only grows beyond its capacity when a single argument
+// does not fit in it.
+template <typename CharT>
+class basic_async_channel final: public strf::basic_outbuff<CharT>
+{
+public:
+
+    static constexpr std::size_t default_capacity = 4096 / sizeof(CharT);
+
+    explicit basic_async_channel(std::size_t capacity = default_capacity)
+        : strf::basic_outbuff<CharT>(nullptr, nullptr)
+        , buf_(new CharT[capacity])
+        , capacity_(capacity)
+        , read_(buf_.get())
+    {
+        STRF_ASSERT(capacity_ >= strf::min_space_after_recycle<CharT>());
+        this->set_pointer(buf_.get());
+        this->set_end(buf_.get() + capacity_);
+    }
+
+    basic_async_channel(const basic_async_channel&) = delete;
+    basic_async_channel(basic_async_channel&&) = delete;
+
+    void recycle() override
+    {
+        compact_();
+        if (this->space() < strf::min_space_after_recycle<CharT>()) {
+            grow_();
+        }
+    }
+
+    // Consumer side
+
+    const CharT* data() const noexcept
+    {
+        return read_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return this->pointer() - read_;
+    }
+
+    bool closed() const noexcept
+    {
+        return closed_;
+    }
+
+    void consume(std::size_t n) noexcept
+    {
+        STRF_ASSERT(n <= size());
+        read_ += n;
+        if (read_ == this->pointer()) {
+            read_ = buf_.get();
+            this->set_pointer(buf_.get());
+        }
+    }
+
+    // Suspends the consumer until there is data available or the
+    // channel is closed. If a producer is waiting for space, it is
+    // resumed instead.
+    auto wait_for_data() noexcept
+    {
+        struct awaiter
+        {
+            basic_async_channel& ch;
+
+            bool await_ready() const noexcept
+            {
+                return ch.size() != 0 || ch.closed_;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) noexcept
+            {
+                if (ch.pending_ != nullptr) {
+                    if ( ! ch.pending_->resume_writing()) {
+                        return h; // there is new data, and the producer still waits
+                    }
+                    ch.pending_ = nullptr;
+                    ch.consumer_ = h;
+                    return std::exchange(ch.producer_, nullptr);
+                }
+                ch.consumer_ = h;
+                return std::noop_coroutine();
+            }
+            void await_resume() const noexcept
+            {
+            }
+        };
+        return awaiter{*this};
+    }
+
+    // Producer side
+
+    // Tells the consumer that nothing more will be written.
+    // Resumes the consumer if it is waiting.
+    void close() noexcept
+    {
+        closed_ = true;
+        if (consumer_) {
+            std::exchange(consumer_, nullptr).resume();
+        }
+    }
+
+    // Whether n characters can be written without exceeding the capacity.
+    // When the buffer is empty, the answer is always yes, in which case
+    // the buffer grows if needed.
+    bool has_space_for(std::size_t n) noexcept
+    {
+        if (this->space() >= n || size() == 0) {
+            return true;
+        }
+        if (read_ != buf_.get()) {
+            compact_();
+            return this->space() >= n;
+        }
+        return false;
+    }
+
+    // Called by a producer that needs to wait for space.
+    std::coroutine_handle<> suspend_producer
+        ( std::coroutine_handle<> h
+        , strf::detail::async_pending_write<CharT>* pending ) noexcept
+    {
+        STRF_ASSERT(pending_ == nullptr);
+        pending_ = pending;
+        producer_ = h;
+        if (consumer_) {
+            return std::exchange(consumer_, nullptr);
+        }
+        return std::noop_coroutine();
+    }
+
+    void cancel_pending(strf::detail::async_pending_write<CharT>* pending) noexcept
+    {
+        if (pending_ == pending) {
+            pending_ = nullptr;
+            producer_ = nullptr;
+        }
+    }
+
+private:
+
+    void compact_() noexcept
+    {
+        std::size_t len = size();
+        if (read_ != buf_.get()) {
+            if (len != 0) {
+                std::char_traits<CharT>::move(buf_.get(), read_, len);
+            }
+            read_ = buf_.get();
+            this->set_pointer(buf_.get() + len);
+        }
+    }
+
+    void grow_()
+    {
+        std::size_t len = size();
+        std::size_t new_capacity = capacity_ * 2;
+        std::unique_ptr<CharT[]> new_buf(new CharT[new_capacity]);
+        strf::detail::copy_n(read_, len, new_buf.get());
+        buf_ = std::move(new_buf);
+        capacity_ = new_capacity;
+        read_ = buf_.get();
+        this->set_pointer(buf_.get() + len);
+        this->set_end(buf_.get() + capacity_);
+    }
+
+    std::unique_ptr<CharT[]> buf_;
+    std::size_t capacity_;
+    CharT* read_;
+    bool closed_ = false;
+    strf::detail::async_pending_write<CharT>* pending_ = nullptr;
+    std::coroutine_handle<> producer_ = nullptr;
+    std::coroutine_handle<> consumer_ = nullptr;
+};
+
+using async_channel = basic_async_channel<char>;
+using u16async_channel = basic_async_channel<char16_t>;
+using u32async_channel = basic_async_channel<char32_t>;
+using wasync_channel = basic_async_channel<wchar_t>;
+
+namespace detail {
+
+// The awaitable returned by async_destination::operator(). The
+// arguments are printed one by one, and the producer suspends before
+// an argument whose size exceeds the free space in the channel.
+template <typename CharT, typename FPack, typename ... Args>
+class async_print_op final: private strf::detail::async_pending_write<CharT>
+{
+    using preview_type_ = strf::print_size_preview;
+
+    static constexpr std::size_t count_ = sizeof...(Args);
+
+public:
+
+    async_print_op
+        ( strf::basic_async_channel<CharT>& ch
+        , const FPack& fpack
+        , const Args& ... args )
+        : async_print_op(ch, std::index_sequence_for<Args...>(), fpack, args...)
+    {
+    }
+
+    async_print_op(const async_print_op&) = delete;
+    async_print_op(async_print_op&&) = delete;
+
+    ~async_print_op()
+    {
+        ch_.cancel_pending(this);
+    }
+
+    bool await_ready() noexcept
+    {
+        return resume_writing();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        return ch_.suspend_producer(h, this);
+    }
+
+    void await_resume() const
+    {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+
+    template <std::size_t ... I>
+    async_print_op
+        ( strf::basic_async_channel<CharT>& ch
+        , std::index_sequence<I...>
+        , const FPack& fpack
+        , const Args& ... args )
+        : ch_(ch)
+        , printers_
+            ( strf::make_printer_input<CharT>(previews_[I], fpack, args)... )
+        , printers_ptrs_{ &std::get<I>(printers_)... }
+    {
+    }
+
+    bool resume_writing() noexcept override
+    {
+        try {
+            while (next_ < count_) {
+                if ( ! ch_.has_space_for(previews_[next_].accumulated_size())) {
+                    return false;
+                }
+                printers_ptrs_[next_]->print_to(ch_);
+                ++next_;
+            }
+        } catch (...) {
+            exception_ = std::current_exception();
+            next_ = count_;
+        }
+        return true;
+    }
+
+    strf::basic_async_channel<CharT>& ch_;
+    preview_type_ previews_[count_ ? count_ : 1];
+    std::tuple<strf::printer_type<CharT, preview_type_, FPack, Args>...> printers_;
+    const strf::printer<CharT>* printers_ptrs_[count_ ? count_ : 1];
+    std::size_t next_ = 0;
+    std::exception_ptr exception_;
+};
+
+} // namespace detail
+
+template <typename CharT, typename FPack = strf::facets_pack<>>
+class async_destination
+{
+public:
+
+    explicit async_destination(strf::basic_async_channel<CharT>& ch)
+        : ch_(ch)
+    {
+    }
+
+    async_destination(strf::basic_async_channel<CharT>& ch, const FPack& fp)
+        : ch_(ch)
+        , fpack_(fp)
+    {
+    }
+
+    template <typename ... FPE>
+    auto with(FPE&& ... fpe) const
+    {
+        using NewFPack = decltype( strf::pack( std::declval<const FPack&>()
+                                             , std::forward<FPE>(fpe) ...) );
+        return strf::async_destination<CharT, NewFPack>
+            { ch_, strf::pack(fpack_, std::forward<FPE>(fpe)...) };
+    }
+
+    // Must be awaited in the same full-expression
+    template <typename ... Args>
+    strf::detail::async_print_op<CharT, FPack, Args...>
+    operator()(const Args& ... args) const
+    {
+        return {ch_, fpack_, args...};
+    }
+
+private:
+
+    strf::basic_async_channel<CharT>& ch_;
+    FPack fpack_;
+};
+
+template <typename CharT>
+inline strf::async_destination<CharT> async_to(strf::basic_async_channel<CharT>& ch)
+{
+    return strf::async_destination<CharT>{ch};
+}
+
+} // namespace strf
+
+#endif // defined(STRF_HAS_COROUTINES)
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_ASYNC_CHANNEL_HPP
@@ -0,0 +1,228 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_ASYNC_FD_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_ASYNC_FD_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_fd.hpp>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace strf {
+
+// Like basic_fd_writer, but the content is written into the file
+// descriptor by a background thread. recycle() hands the full buffer
+// to that thread and continues in the next one. It only waits when
+// all buffers are still pending to be written.
+template <typename CharT>
+class basic_async_fd_writer final: public strf::basic_outbuff<CharT>
+{
+public:
+
+    static constexpr std::size_t default_buffer_size = 65536 / sizeof(CharT);
+    static constexpr std::size_t default_buffers_count = 2;
+
+    struct settings
+    {
+        int fd;
+        std::size_t buffer_size;
+        std::size_t buffers_count;
+    };
+
+    explicit basic_async_fd_writer(settings s)
+        : strf::basic_outbuff<CharT>(nullptr, nullptr)
+        , fd_(s.fd)
+        , buf_size_(s.buffer_size)
+        , bufs_count_(s.buffers_count)
+        , bufs_(new CharT[s.buffer_size * s.buffers_count])
+        , lengths_(new std::size_t[s.buffers_count])
+    {
+        STRF_ASSERT(buf_size_ >= strf::min_space_after_recycle<CharT>());
+        STRF_ASSERT(bufs_count_ >= 2);
+        this->set_pointer(bufs_.get());
+        this->set_end(bufs_.get() + buf_size_);
+        io_thread_ = std::thread([this]{ io_loop_(); });
+    }
+
+    explicit basic_async_fd_writer
+        ( int fd
+        , std::size_t buffer_size = default_buffer_size
+        , std::size_t buffers_count = default_buffers_count )
+        : basic_async_fd_writer(settings{fd, buffer_size, buffers_count})
+    {
+    }
+
+    basic_async_fd_writer(const basic_async_fd_writer&) = delete;
+    basic_async_fd_writer(basic_async_fd_writer&&) = delete;
+
+    ~basic_async_fd_writer()
+    {
+        if (io_thread_.joinable()) {
+            stop_io_thread_();
+        }
+    }
+
+    void recycle() override
+    {
+        if (this->good()) {
+            submit_();
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait(lock, [this]{ return submitted_ - written_ < bufs_count_; });
+            this->set_good( ! failed_);
+        }
+        if (this->good()) {
+            this->set_pointer(current_buffer_());
+            this->set_end(current_buffer_() + buf_size_);
+        } else {
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        }
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    // Waits until all the content is written.
+    result finish()
+    {
+        bool g = this->good();
+        if (g) {
+            submit_();
+        }
+        this->set_good(false);
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        if (io_thread_.joinable()) {
+            stop_io_thread_();
+        }
+        return {count_, g && ! failed_};
+    }
+
+private:
+
+    CharT* current_buffer_() const noexcept
+    {
+        return bufs_.get() + (submitted_ % bufs_count_) * buf_size_;
+    }
+
+    void submit_()
+    {
+        std::size_t len = this->pointer() - current_buffer_();
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            lengths_[submitted_ % bufs_count_] = len;
+            ++submitted_;
+        }
+        cv_.notify_all();
+    }
+
+    void stop_io_thread_()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        io_thread_.join();
+    }
+
+    void io_loop_()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        for(;;) {
+            cv_.wait(lock, [this]{ return written_ != submitted_ || stop_; });
+            if (written_ == submitted_) {
+                return; // stopped and nothing left to write
+            }
+            auto idx = written_ % bufs_count_;
+            const CharT* buf = bufs_.get() + idx * buf_size_;
+            std::size_t len = lengths_[idx];
+            bool failed = failed_;
+            lock.unlock();
+
+            std::size_t bytes = 0;
+            if ( ! failed) {
+                bytes = strf::detail::fd_write_all(fd_, buf, len * sizeof(CharT));
+            }
+
+            lock.lock();
+            count_ += bytes / sizeof(CharT);
+            failed_ = failed_ || bytes != len * sizeof(CharT);
+            ++written_;
+            cv_.notify_all();
+        }
+    }
+
+    int fd_;
+    std::size_t buf_size_;
+    std::size_t bufs_count_;
+    std::unique_ptr<CharT[]> bufs_;
+    std::unique_ptr<std::size_t[]> lengths_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::size_t submitted_ = 0; // guarded by mtx_
+    std::size_t written_ = 0;   // guarded by mtx_
+    std::size_t count_ = 0;     // guarded by mtx_
+    bool failed_ = false;       // guarded by mtx_
+    bool stop_ = false;         // guarded by mtx_
+    std::thread io_thread_;
+};
+
+using async_fd_writer = basic_async_fd_writer<char>;
+using u16async_fd_writer = basic_async_fd_writer<char16_t>;
+using u32async_fd_writer = basic_async_fd_writer<char32_t>;
+using wasync_fd_writer = basic_async_fd_writer<wchar_t>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_async_fd_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_async_fd_writer<CharT>;
+    using finish_type = typename outbuff_type::result;
+
+    constexpr basic_async_fd_writer_creator
+        ( int fd, std::size_t buffer_size, std::size_t buffers_count ) noexcept
+        : settings_{fd, buffer_size, buffers_count}
+    {
+    }
+
+    constexpr basic_async_fd_writer_creator
+        (const basic_async_fd_writer_creator&) = default;
+
+    typename outbuff_type::settings create() const noexcept
+    {
+        return settings_;
+    }
+
+private:
+
+    typename outbuff_type::settings settings_;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_async_fd
+    ( int fd
+    , std::size_t buffer_size = strf::basic_async_fd_writer<CharT>::default_buffer_size
+    , std::size_t buffers_count = strf::basic_async_fd_writer<CharT>::default_buffers_count )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_async_fd_writer_creator<CharT> >
+        (fd, buffer_size, buffers_count);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_ASYNC_FD_HPP
@@ -17,11 +17,40 @@ class narrow_cfile_writer final: public strf::basic_outbuff_noexcept<CharT>
 {
 public:
 
+    struct settings
+    {
+        std::FILE* file;
+        CharT* buffer;
+        std::size_t buffer_size;
+    };
+
     explicit STRF_HD narrow_cfile_writer(std::FILE* d)
-        : strf::basic_outbuff_noexcept<CharT>(buf_, buf_size_)
+        : strf::basic_outbuff_noexcept<CharT>(default_buf_, default_buf_size_)
+        , dest_(d)
+        , buf_(default_buf_)
+    {
+        STRF_ASSERT(d != nullptr);
+    }
+
+    STRF_HD narrow_cfile_writer(std::FILE* d, CharT* buffer, std::size_t buffer_size)
+        : strf::basic_outbuff_noexcept<CharT>(buffer, buffer_size)
         , dest_(d)
+        , buf_(buffer)
     {
         STRF_ASSERT(d != nullptr);
+        STRF_ASSERT(buffer_size >= strf::min_space_after_recycle<CharT>());
+    }
+
+    explicit STRF_HD narrow_cfile_writer(settings s)
+        : strf::basic_outbuff_noexcept<CharT>
+            ( s.buffer ? s.buffer : default_buf_
+            , s.buffer ? s.buffer_size : default_buf_size_ )
+        , dest_(s.file)
+        , buf_(s.buffer ? s.buffer : default_buf_)
+    {
+        STRF_ASSERT(s.file != nullptr);
+        STRF_ASSERT( s.buffer == nullptr
+                  || s.buffer_size >= strf::min_space_after_recycle<CharT>() );
     }
 
     STRF_HD narrow_cfile_writer() = delete;
@@ -68,20 +97,50 @@ private:
 
     std::FILE* dest_;
     std::size_t count_ = 0;
-    static constexpr std::size_t buf_size_
+    CharT* buf_;
+    static constexpr std::size_t default_buf_size_
         = strf::min_space_after_recycle<CharT>();
-    CharT buf_[buf_size_];
+    CharT default_buf_[default_buf_size_];
 };
 
 class wide_cfile_writer final: public strf::basic_outbuff_noexcept<wchar_t>
 {
 public:
 
+    struct settings
+    {
+        std::FILE* file;
+        wchar_t* buffer;
+        std::size_t buffer_size;
+    };
+
     STRF_HD explicit wide_cfile_writer(std::FILE* d)
-        : strf::basic_outbuff_noexcept<wchar_t>(buf_, buf_size_)
+        : strf::basic_outbuff_noexcept<wchar_t>(default_buf_, default_buf_size_)
+        , dest_(d)
+        , buf_(default_buf_)
+    {
+        STRF_ASSERT(d != nullptr);
+    }
+
+    STRF_HD wide_cfile_writer(std::FILE* d, wchar_t* buffer, std::size_t buffer_size)
+        : strf::basic_outbuff_noexcept<wchar_t>(buffer, buffer_size)
         , dest_(d)
+        , buf_(buffer)
     {
         STRF_ASSERT(d != nullptr);
+        STRF_ASSERT(buffer_size >= strf::min_space_after_recycle<wchar_t>());
+    }
+
+    STRF_HD explicit wide_cfile_writer(settings s)
+        : strf::basic_outbuff_noexcept<wchar_t>
+            ( s.buffer ? s.buffer : default_buf_
+            , s.buffer ? s.buffer_size : default_buf_size_ )
+        , dest_(s.file)
+        , buf_(s.buffer ? s.buffer : default_buf_)
+    {
+        STRF_ASSERT(s.file != nullptr);
+        STRF_ASSERT( s.buffer == nullptr
+                  || s.buffer_size >= strf::min_space_after_recycle<wchar_t>() );
     }
 
     wide_cfile_writer() = delete;
@@ -124,8 +183,10 @@ public:
 
     std::FILE* dest_;
     std::size_t count_ = 0;
-    static constexpr std::size_t buf_size_ = strf::min_space_after_recycle<wchar_t>();
-    wchar_t buf_[buf_size_];
+    wchar_t* buf_;
+    static constexpr std::size_t default_buf_size_
+        = strf::min_space_after_recycle<wchar_t>();
+    wchar_t default_buf_[default_buf_size_];
 };
 
 namespace detail {
@@ -140,19 +201,24 @@ public:
     using finish_type = typename outbuff_type::result;
 
     constexpr narrow_cfile_writer_creator(FILE* file) noexcept
-        : file_(file)
+        : settings_{file, nullptr, 0}
+    {}
+
+    constexpr narrow_cfile_writer_creator
+        ( FILE* file, CharT* buffer, std::size_t buffer_size ) noexcept
+        : settings_{file, buffer, buffer_size}
     {}
 
     constexpr narrow_cfile_writer_creator
         (const narrow_cfile_writer_creator&) = default;
 
-    STRF_HD FILE* create() const
+    STRF_HD typename outbuff_type::settings create() const
     {
-        return file_;
+        return settings_;
     }
 
 private:
-    FILE* file_;
+    typename outbuff_type::settings settings_;
 };
 
 class wide_cfile_writer_creator
@@ -164,19 +230,24 @@ public:
     using finish_type = typename outbuff_type::result;
 
     constexpr wide_cfile_writer_creator(FILE* file) noexcept
-        : file_(file)
+        : settings_{file, nullptr, 0}
+    {}
+
+    constexpr wide_cfile_writer_creator
+        ( FILE* file, wchar_t* buffer, std::size_t buffer_size ) noexcept
+        : settings_{file, buffer, buffer_size}
     {}
 
     constexpr wide_cfile_writer_creator(const wide_cfile_writer_creator&) = default;
 
-    STRF_HD FILE* create() const noexcept
+    STRF_HD typename outbuff_type::settings create() const noexcept
     {
-        return file_;
+        return settings_;
     }
 
 private:
 
-    FILE* file_;
+    typename outbuff_type::settings settings_;
 };
 
 } // namespace detail
@@ -190,6 +261,25 @@ STRF_HD inline auto to(std::FILE* destination)
         (destination);
 }
 
+template <typename CharT>
+STRF_HD inline auto to
+    ( std::FILE* destination
+    , CharT* buffer
+    , std::size_t buffer_size )
+{
+    return strf::destination_no_reserve
+        < strf::detail::narrow_cfile_writer_creator<CharT> >
+        (destination, buffer, buffer_size);
+}
+
+template <typename CharT, std::size_t N>
+STRF_HD inline auto to(std::FILE* destination, CharT (&buffer)[N])
+{
+    return strf::destination_no_reserve
+        < strf::detail::narrow_cfile_writer_creator<CharT> >
+        (destination, buffer, N);
+}
+
 STRF_HD inline auto wto(std::FILE* destination)
 {
     return strf::destination_no_reserve
@@ -197,6 +287,24 @@ STRF_HD inline auto wto(std::FILE* destination)
         (destination);
 }
 
+STRF_HD inline auto wto
+    ( std::FILE* destination
+    , wchar_t* buffer
+    , std::size_t buffer_size )
+{
+    return strf::destination_no_reserve
+        < strf::detail::wide_cfile_writer_creator >
+        (destination, buffer, buffer_size);
+}
+
+template <std::size_t N>
+STRF_HD inline auto wto(std::FILE* destination, wchar_t (&buffer)[N])
+{
+    return strf::destination_no_reserve
+        < strf::detail::wide_cfile_writer_creator >
+        (destination, buffer, N);
+}
+
 
 } // namespace strf
 
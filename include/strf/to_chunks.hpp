@@ -0,0 +1,281 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_CHUNKS_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_CHUNKS_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace strf {
+
+// Hands out chunks of chunk_size() characters. Released chunks are
+// kept in a free list and reused, and are only deallocated when the
+// pool is destroyed.
+template <typename CharT>
+class basic_chunk_pool
+{
+public:
+
+    static constexpr std::size_t default_chunk_size = 4096 / sizeof(CharT);
+
+    explicit basic_chunk_pool(std::size_t chunk_size = default_chunk_size) noexcept
+        : chunk_size_(chunk_size)
+    {
+        STRF_ASSERT(chunk_size_ >= strf::min_space_after_recycle<CharT>());
+    }
+
+    basic_chunk_pool(const basic_chunk_pool&) = delete;
+    basic_chunk_pool(basic_chunk_pool&&) = delete;
+
+    ~basic_chunk_pool()
+    {
+        while (free_list_ != nullptr) {
+            delete [] pop_();
+        }
+    }
+
+    std::size_t chunk_size() const noexcept
+    {
+        return chunk_size_;
+    }
+
+    CharT* acquire()
+    {
+        if (free_list_ != nullptr) {
+            return pop_();
+        }
+        return new CharT[chunk_size_];
+    }
+
+    void release(CharT* chunk) noexcept
+    {
+        // the free list is stored inside the released chunks
+        std::memcpy(chunk, &free_list_, sizeof(free_list_));
+        free_list_ = chunk;
+    }
+
+private:
+
+    CharT* pop_() noexcept
+    {
+        CharT* chunk = free_list_;
+        std::memcpy(&free_list_, chunk, sizeof(free_list_));
+        return chunk;
+    }
+
+    std::size_t chunk_size_;
+    CharT* free_list_ = nullptr;
+};
+
+// The result of basic_chunks_writer. Each segment occupies the
+// beginning of a chunk, which is returned to the pool when the
+// object is destroyed.
+template <typename CharT>
+class basic_chunk_list
+{
+public:
+
+    struct segment
+    {
+        const CharT* data;
+        std::size_t size;
+    };
+
+    basic_chunk_list
+        ( strf::basic_chunk_pool<CharT>& pool
+        , std::vector<segment>&& segments
+        , std::size_t size ) noexcept
+        : pool_(&pool)
+        , segments_(std::move(segments))
+        , size_(size)
+    {
+    }
+
+    basic_chunk_list(basic_chunk_list&& other) noexcept
+        : pool_(other.pool_)
+        , segments_(std::move(other.segments_))
+        , size_(other.size_)
+    {
+        other.segments_.clear();
+        other.size_ = 0;
+    }
+
+    basic_chunk_list(const basic_chunk_list&) = delete;
+
+    ~basic_chunk_list()
+    {
+        for (auto& s: segments_) {
+            pool_->release(const_cast<CharT*>(s.data));
+        }
+    }
+
+    const std::vector<segment>& segments() const noexcept
+    {
+        return segments_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    CharT* copy_to(CharT* dest) const noexcept
+    {
+        for (const auto& s: segments_) {
+            strf::detail::copy_n(s.data, s.size, dest);
+            dest += s.size;
+        }
+        return dest;
+    }
+
+    std::basic_string<CharT> to_string() const
+    {
+        std::basic_string<CharT> str;
+        str.reserve(size_);
+        for (const auto& s: segments_) {
+            str.append(s.data, s.size);
+        }
+        return str;
+    }
+
+private:
+
+    strf::basic_chunk_pool<CharT>* pool_;
+    std::vector<segment> segments_;
+    std::size_t size_;
+};
+
+// Writes into chunks taken from a basic_chunk_pool. recycle() just
+// moves to a new chunk, so the content already written is never
+// copied nor reallocated.
+template <typename CharT>
+class basic_chunks_writer final: public strf::basic_outbuff<CharT>
+{
+public:
+
+    explicit basic_chunks_writer(strf::basic_chunk_pool<CharT>& pool)
+        : strf::basic_outbuff<CharT>(nullptr, nullptr)
+        , pool_(pool)
+    {
+        new_chunk_();
+    }
+
+    basic_chunks_writer(const basic_chunks_writer&) = delete;
+    basic_chunks_writer(basic_chunks_writer&&) = delete;
+
+    ~basic_chunks_writer()
+    {
+        for (auto& s: segments_) {
+            pool_.release(const_cast<CharT*>(s.data));
+        }
+        if (chunk_ != nullptr) {
+            pool_.release(chunk_);
+        }
+    }
+
+    void recycle() override
+    {
+        if (this->good()) {
+            if (this->pointer() != chunk_) {
+                this->set_good(false);
+                close_chunk_();
+                new_chunk_();
+                this->set_good(true);
+            }
+        } else {
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        }
+    }
+
+    strf::basic_chunk_list<CharT> finish()
+    {
+        if (this->good()) {
+            this->set_good(false);
+            if (this->pointer() != chunk_) {
+                close_chunk_();
+            }
+        }
+        if (chunk_ != nullptr) {
+            pool_.release(chunk_);
+            chunk_ = nullptr;
+        }
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        return {pool_, std::move(segments_), count_};
+    }
+
+private:
+
+    void close_chunk_()
+    {
+        std::size_t size = this->pointer() - chunk_;
+        segments_.push_back({chunk_, size});
+        count_ += size;
+        chunk_ = nullptr;
+    }
+
+    void new_chunk_()
+    {
+        chunk_ = pool_.acquire();
+        this->set_pointer(chunk_);
+        this->set_end(chunk_ + pool_.chunk_size());
+    }
+
+    strf::basic_chunk_pool<CharT>& pool_;
+    CharT* chunk_ = nullptr;
+    std::size_t count_ = 0;
+    std::vector<typename strf::basic_chunk_list<CharT>::segment> segments_;
+};
+
+using chunk_pool = basic_chunk_pool<char>;
+using chunk_list = basic_chunk_list<char>;
+using chunks_writer = basic_chunks_writer<char>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_chunks_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_chunks_writer<CharT>;
+    using finish_type = strf::basic_chunk_list<CharT>;
+
+    constexpr explicit basic_chunks_writer_creator
+        ( strf::basic_chunk_pool<CharT>& pool ) noexcept
+        : pool_(&pool)
+    {
+    }
+
+    constexpr basic_chunks_writer_creator
+        (const basic_chunks_writer_creator&) = default;
+
+    strf::basic_chunk_pool<CharT>& create() const noexcept
+    {
+        return *pool_;
+    }
+
+private:
+
+    strf::basic_chunk_pool<CharT>* pool_;
+};
+
+} // namespace detail
+
+template <typename CharT>
+inline auto to_chunks(strf::basic_chunk_pool<CharT>& pool)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_chunks_writer_creator<CharT> >
+        (pool);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_CHUNKS_HPP
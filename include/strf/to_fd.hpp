@@ -0,0 +1,216 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_FD_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_FD_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <cerrno>
+
+#if defined(_WIN32)
+#include <io.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#else
+#error "<strf/to_fd.hpp> requires a POSIX system or Windows"
+#endif
+
+namespace strf {
+
+namespace detail {
+
+// Writes the whole range [data, data + size), retrying on partial
+// writes and on EINTR. Returns the number of bytes actually written.
+inline std::size_t fd_write_all(int fd, const void* data, std::size_t size) noexcept
+{
+    auto it = static_cast<const char*>(data);
+    std::size_t written = 0;
+    while (written < size) {
+#if defined(_WIN32)
+        auto chunk = size - written;
+        if (chunk > 0x7FFFFFFF) {
+            chunk = 0x7FFFFFFF;
+        }
+        auto r = ::_write(fd, it + written, static_cast<unsigned>(chunk));
+#else
+        auto r = ::write(fd, it + written, size - written);
+#endif
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (r == 0) {
+            break;
+        }
+        written += static_cast<std::size_t>(r);
+    }
+    return written;
+}
+
+} // namespace detail
+
+template <typename CharT>
+class basic_fd_writer final: public strf::basic_outbuff_noexcept<CharT>
+{
+public:
+
+    static constexpr std::size_t default_buffer_size = 4096 / sizeof(CharT);
+
+    struct settings
+    {
+        int fd;
+        CharT* buffer;
+        std::size_t buffer_size;
+    };
+
+    explicit basic_fd_writer(settings s)
+        : strf::basic_outbuff_noexcept<CharT>(nullptr, nullptr)
+        , fd_(s.fd)
+        , buf_(s.buffer != nullptr ? s.buffer : new CharT[s.buffer_size])
+        , buf_size_(s.buffer_size)
+        , owns_buf_(s.buffer == nullptr)
+    {
+        STRF_ASSERT(buf_size_ >= strf::min_space_after_recycle<CharT>());
+        this->set_pointer(buf_);
+        this->set_end(buf_ + buf_size_);
+    }
+
+    explicit basic_fd_writer(int fd, std::size_t buffer_size = default_buffer_size)
+        : basic_fd_writer(settings{fd, nullptr, buffer_size})
+    {
+    }
+
+    basic_fd_writer(int fd, CharT* buffer, std::size_t buffer_size)
+        : basic_fd_writer(settings{fd, buffer, buffer_size})
+    {
+        STRF_ASSERT(buffer != nullptr);
+    }
+
+    basic_fd_writer() = delete;
+    basic_fd_writer(const basic_fd_writer&) = delete;
+    basic_fd_writer(basic_fd_writer&&) = delete;
+
+    ~basic_fd_writer()
+    {
+        if (owns_buf_) {
+            delete [] buf_;
+        }
+    }
+
+    void recycle() noexcept override
+    {
+        auto p = this->pointer();
+        this->set_pointer(buf_);
+        if (this->good()) {
+            this->set_good(write_(p));
+        }
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    result finish() noexcept
+    {
+        bool g = this->good();
+        this->set_good(false);
+        if (g) {
+            g = write_(this->pointer());
+        }
+        this->set_pointer(buf_);
+        return {count_, g};
+    }
+
+private:
+
+    bool write_(CharT* p) noexcept
+    {
+        std::size_t count = p - buf_;
+        std::size_t bytes = count * sizeof(CharT);
+        auto bytes_written = strf::detail::fd_write_all(fd_, buf_, bytes);
+        count_ += bytes_written / sizeof(CharT);
+        return bytes_written == bytes;
+    }
+
+    int fd_;
+    std::size_t count_ = 0;
+    CharT* buf_;
+    std::size_t buf_size_;
+    bool owns_buf_;
+};
+
+using fd_writer = basic_fd_writer<char>;
+using u16fd_writer = basic_fd_writer<char16_t>;
+using u32fd_writer = basic_fd_writer<char32_t>;
+using wfd_writer = basic_fd_writer<wchar_t>;
+
+#if defined(__cpp_char8_t)
+using u8fd_writer = basic_fd_writer<char8_t>;
+#endif
+
+namespace detail {
+
+template <typename CharT>
+class basic_fd_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_fd_writer<CharT>;
+    using finish_type = typename outbuff_type::result;
+
+    constexpr basic_fd_writer_creator
+        ( int fd, CharT* buffer, std::size_t buffer_size ) noexcept
+        : settings_{fd, buffer, buffer_size}
+    {
+    }
+
+    constexpr basic_fd_writer_creator
+        (const basic_fd_writer_creator&) = default;
+
+    typename outbuff_type::settings create() const noexcept
+    {
+        return settings_;
+    }
+
+private:
+
+    typename outbuff_type::settings settings_;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_fd
+    ( int fd
+    , std::size_t buffer_size = strf::basic_fd_writer<CharT>::default_buffer_size )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_fd_writer_creator<CharT> >
+        (fd, nullptr, buffer_size);
+}
+
+template <typename CharT>
+inline auto to_fd(int fd, CharT* buffer, std::size_t buffer_size)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_fd_writer_creator<CharT> >
+        (fd, buffer, buffer_size);
+}
+
+template <typename CharT, std::size_t N>
+inline auto to_fd(int fd, CharT (&buffer)[N])
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_fd_writer_creator<CharT> >
+        (fd, buffer, N);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_FD_HPP
@@ -0,0 +1,266 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_HASH_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_HASH_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <cstdint>
+
+namespace strf {
+
+// 64-bit FNV-1a
+class fnv1a_64
+{
+public:
+
+    using result_type = std::uint64_t;
+
+    void update(const void* data, std::size_t size) noexcept
+    {
+        auto it = static_cast<const unsigned char*>(data);
+        auto end = it + size;
+        std::uint64_t h = h_;
+        for (; it != end; ++it) {
+            h = (h ^ *it) * 1099511628211ull;
+        }
+        h_ = h;
+    }
+
+    std::uint64_t digest() const noexcept
+    {
+        return h_;
+    }
+
+private:
+
+    std::uint64_t h_ = 14695981039346656037ull;
+};
+
+// XXH64, from the xxHash family of hash functions, by Yann Collet
+class xxhash64
+{
+public:
+
+    using result_type = std::uint64_t;
+
+    explicit xxhash64(std::uint64_t seed = 0) noexcept
+        : v1_(seed + p1_ + p2_)
+        , v2_(seed + p2_)
+        , v3_(seed)
+        , v4_(seed - p1_)
+    {
+    }
+
+    void update(const void* data, std::size_t size) noexcept
+    {
+        auto it = static_cast<const unsigned char*>(data);
+        auto end = it + size;
+        total_len_ += size;
+        if (mem_size_ + size < 32) {
+            strf::detail::copy_n(it, size, mem_ + mem_size_);
+            mem_size_ += static_cast<unsigned>(size);
+            return;
+        }
+        if (mem_size_ != 0) {
+            auto n = 32 - mem_size_;
+            strf::detail::copy_n(it, n, mem_ + mem_size_);
+            it += n;
+            consume_stripe_(mem_);
+            mem_size_ = 0;
+        }
+        for(; end - it >= 32; it += 32) {
+            consume_stripe_(it);
+        }
+        mem_size_ = static_cast<unsigned>(end - it);
+        strf::detail::copy_n(it, mem_size_, mem_);
+    }
+
+    std::uint64_t digest() const noexcept
+    {
+        std::uint64_t h;
+        if (total_len_ >= 32) {
+            h = rotl_(v1_, 1) + rotl_(v2_, 7) + rotl_(v3_, 12) + rotl_(v4_, 18);
+            h = merge_round_(h, v1_);
+            h = merge_round_(h, v2_);
+            h = merge_round_(h, v3_);
+            h = merge_round_(h, v4_);
+        } else {
+            h = v3_ + p5_; // v3_ is the seed
+        }
+        h += total_len_;
+
+        const unsigned char* it = mem_;
+        const unsigned char* end = mem_ + mem_size_;
+        for (; end - it >= 8; it += 8) {
+            h ^= round_(0, read64_(it));
+            h = rotl_(h, 27) * p1_ + p4_;
+        }
+        if (end - it >= 4) {
+            h ^= read32_(it) * p1_;
+            h = rotl_(h, 23) * p2_ + p3_;
+            it += 4;
+        }
+        for (; it != end; ++it) {
+            h ^= *it * p5_;
+            h = rotl_(h, 11) * p1_;
+        }
+        h ^= h >> 33;
+        h *= p2_;
+        h ^= h >> 29;
+        h *= p3_;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+
+    static constexpr std::uint64_t p1_ = 11400714785074694791ull;
+    static constexpr std::uint64_t p2_ = 14029467366897019727ull;
+    static constexpr std::uint64_t p3_ = 1609587929392839161ull;
+    static constexpr std::uint64_t p4_ = 9650029242287828579ull;
+    static constexpr std::uint64_t p5_ = 2870177450012600261ull;
+
+    static std::uint64_t rotl_(std::uint64_t x, int r) noexcept
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+    static std::uint64_t round_(std::uint64_t acc, std::uint64_t input) noexcept
+    {
+        return rotl_(acc + input * p2_, 31) * p1_;
+    }
+    static std::uint64_t merge_round_(std::uint64_t acc, std::uint64_t val) noexcept
+    {
+        return (acc ^ round_(0, val)) * p1_ + p4_;
+    }
+    static std::uint64_t read32_(const unsigned char* p) noexcept
+    {
+        return (std::uint64_t)p[0]         | ((std::uint64_t)p[1] << 8)
+            | ((std::uint64_t)p[2] << 16) | ((std::uint64_t)p[3] << 24);
+    }
+    static std::uint64_t read64_(const unsigned char* p) noexcept
+    {
+        return read32_(p) | (read32_(p + 4) << 32);
+    }
+    void consume_stripe_(const unsigned char* p) noexcept
+    {
+        v1_ = round_(v1_, read64_(p));
+        v2_ = round_(v2_, read64_(p + 8));
+        v3_ = round_(v3_, read64_(p + 16));
+        v4_ = round_(v4_, read64_(p + 24));
+    }
+
+    std::uint64_t v1_;
+    std::uint64_t v2_;
+    std::uint64_t v3_;
+    std::uint64_t v4_;
+    std::uint64_t total_len_ = 0;
+    unsigned char mem_[32];
+    unsigned mem_size_ = 0;
+};
+
+// Feeds the content into a hasher each time the internal buffer is full,
+// so that the whole string never needs to exist in memory.
+// Hasher must provide update(const void*, std::size_t) and digest().
+template <typename CharT, typename Hasher>
+class basic_hash_writer final: public strf::basic_outbuff<CharT>
+{
+public:
+
+    using result = decltype(std::declval<const Hasher&>().digest());
+
+    static constexpr std::size_t buffer_size = 512 / sizeof(CharT);
+
+    explicit basic_hash_writer(const Hasher& hasher = Hasher())
+        : strf::basic_outbuff<CharT>(buf_, buf_ + buffer_size)
+        , hasher_(hasher)
+    {
+    }
+
+    basic_hash_writer(const basic_hash_writer&) = delete;
+    basic_hash_writer(basic_hash_writer&&) = delete;
+
+    void recycle() override
+    {
+        if (this->good()) {
+            auto len = this->pointer() - buf_;
+            this->set_pointer(buf_);
+            this->set_good(false);
+            hasher_.update(buf_, len * sizeof(CharT));
+            this->set_good(true);
+        } else {
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        }
+    }
+
+    result finish()
+    {
+        if (this->good()) {
+            auto len = this->pointer() - buf_;
+            this->set_good(false);
+            hasher_.update(buf_, len * sizeof(CharT));
+        }
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        return hasher_.digest();
+    }
+
+private:
+
+    Hasher hasher_;
+    CharT buf_[buffer_size];
+};
+
+template <typename Hasher = strf::fnv1a_64>
+using hash_writer = basic_hash_writer<char, Hasher>;
+
+template <typename Hasher = strf::fnv1a_64>
+using u16hash_writer = basic_hash_writer<char16_t, Hasher>;
+
+template <typename Hasher = strf::fnv1a_64>
+using u32hash_writer = basic_hash_writer<char32_t, Hasher>;
+
+template <typename Hasher = strf::fnv1a_64>
+using whash_writer = basic_hash_writer<wchar_t, Hasher>;
+
+namespace detail {
+
+template <typename CharT, typename Hasher>
+class basic_hash_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_hash_writer<CharT, Hasher>;
+    using finish_type = typename outbuff_type::result;
+
+    explicit basic_hash_writer_creator(const Hasher& hasher)
+        : hasher_(hasher)
+    {
+    }
+
+    const Hasher& create() const noexcept
+    {
+        return hasher_;
+    }
+
+private:
+
+    Hasher hasher_;
+};
+
+} // namespace detail
+
+template <typename Hasher = strf::fnv1a_64, typename CharT = char>
+inline auto to_hash(const Hasher& hasher = Hasher())
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_hash_writer_creator<CharT, Hasher> >
+        (hasher);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_HASH_HPP
@@ -0,0 +1,399 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_IOVEC_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_IOVEC_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <cerrno>
+#include <memory>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#else
+#error "<strf/to_iovec.hpp> requires a POSIX system"
+#endif
+
+namespace strf {
+
+namespace detail {
+
+// Calls writev until all segments are written, or an error other
+// than EINTR happens. Adjusts the segments when there are partial
+// writes. Returns the number of bytes written.
+inline std::size_t writev_all(int fd, ::iovec* iov, int iovcnt) noexcept
+{
+    std::size_t written = 0;
+    while (iovcnt > 0) {
+        auto r = ::writev(fd, iov, iovcnt);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (r == 0) {
+            break;
+        }
+        written += static_cast<std::size_t>(r);
+        auto remaining = static_cast<std::size_t>(r);
+        while (iovcnt > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return written;
+}
+
+template <typename CharT>
+inline ::iovec make_iovec(const CharT* str, std::size_t len) noexcept
+{
+    ::iovec v;
+    v.iov_base = const_cast<CharT*>(str);
+    v.iov_len = len * sizeof(CharT);
+    return v;
+}
+
+} // namespace detail
+
+// Collects the output as a list of iovec segments. The characters
+// written by printers are stored in chunks owned by the result.
+// Strings of at least borrow_threshold characters are not copied:
+// the segments refer to the original string instead. Hence they
+// must remain valid as long as the segments are used.
+template <typename CharT>
+class basic_iovec_writer final: public strf::basic_outbuff<CharT>
+{
+public:
+
+    static constexpr std::size_t default_chunk_size = 4096 / sizeof(CharT);
+    static constexpr std::size_t default_borrow_threshold = 256;
+
+    struct settings
+    {
+        std::size_t chunk_size;
+        std::size_t borrow_threshold;
+    };
+
+    explicit basic_iovec_writer(settings s)
+        : strf::basic_outbuff<CharT>(nullptr, nullptr)
+        , chunk_size_(s.chunk_size)
+        , borrow_threshold_(s.borrow_threshold)
+    {
+        STRF_ASSERT(chunk_size_ >= strf::min_space_after_recycle<CharT>());
+        this->set_can_borrow(true);
+        new_chunk_();
+    }
+
+    explicit basic_iovec_writer
+        ( std::size_t chunk_size = default_chunk_size
+        , std::size_t borrow_threshold = default_borrow_threshold )
+        : basic_iovec_writer(settings{chunk_size, borrow_threshold})
+    {
+    }
+
+    basic_iovec_writer(const basic_iovec_writer&) = delete;
+    basic_iovec_writer(basic_iovec_writer&&) = delete;
+
+    void recycle() override
+    {
+        if (this->good()) {
+            this->set_good(false);
+            close_segment_();
+            new_chunk_();
+            this->set_good(true);
+        } else {
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        }
+    }
+
+    bool borrow(const CharT* str, std::size_t len) override
+    {
+        if (len < borrow_threshold_ || ! this->good()) {
+            return false;
+        }
+        this->set_good(false);
+        close_segment_();
+        segments_.push_back(strf::detail::make_iovec(str, len));
+        count_ += len;
+        this->set_good(true);
+        return true;
+    }
+
+    struct result
+    {
+        std::vector<::iovec> segments;
+        std::size_t count;
+        std::vector<std::unique_ptr<CharT[]>> storage;
+    };
+
+    result finish()
+    {
+        if (this->good()) {
+            this->set_good(false);
+            close_segment_();
+        }
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        return {std::move(segments_), count_, std::move(chunks_)};
+    }
+
+private:
+
+    void close_segment_()
+    {
+        auto p = this->pointer();
+        if (p != segment_begin_) {
+            segments_.push_back(strf::detail::make_iovec(segment_begin_, p - segment_begin_));
+            count_ += p - segment_begin_;
+            segment_begin_ = p;
+        }
+    }
+
+    void new_chunk_()
+    {
+        chunks_.emplace_back(new CharT[chunk_size_]);
+        CharT* chunk = chunks_.back().get();
+        segment_begin_ = chunk;
+        this->set_pointer(chunk);
+        this->set_end(chunk + chunk_size_);
+    }
+
+    std::size_t chunk_size_;
+    std::size_t borrow_threshold_;
+    std::size_t count_ = 0;
+    CharT* segment_begin_ = nullptr;
+    std::vector<::iovec> segments_;
+    std::vector<std::unique_ptr<CharT[]>> chunks_;
+};
+
+// Sends the output to a file descriptor with writev. Strings of at
+// least borrow_threshold characters are not copied into the buffer,
+// but are passed to writev directly. Calls writev when the buffer
+// is full or when there is no more room for segments.
+// Hence a borrowed string is only read in the next call to recycle()
+// or finish(), which may happen after the print expression that
+// wrote it. So when the writer is used through strf::to(ob),
+// such strings must remain valid until finish() is called.
+template <typename CharT>
+class basic_writev_writer final: public strf::basic_outbuff_noexcept<CharT>
+{
+public:
+
+    static constexpr std::size_t default_buffer_size = 4096 / sizeof(CharT);
+    static constexpr std::size_t default_borrow_threshold = 256;
+
+    struct settings
+    {
+        int fd;
+        std::size_t buffer_size;
+        std::size_t borrow_threshold;
+    };
+
+    explicit basic_writev_writer(settings s)
+        : strf::basic_outbuff_noexcept<CharT>(nullptr, nullptr)
+        , fd_(s.fd)
+        , buf_(new CharT[s.buffer_size])
+        , buf_size_(s.buffer_size)
+        , borrow_threshold_(s.borrow_threshold)
+    {
+        STRF_ASSERT(buf_size_ >= strf::min_space_after_recycle<CharT>());
+        this->set_can_borrow(true);
+        segment_begin_ = buf_.get();
+        this->set_pointer(buf_.get());
+        this->set_end(buf_.get() + buf_size_);
+    }
+
+    explicit basic_writev_writer
+        ( int fd
+        , std::size_t buffer_size = default_buffer_size
+        , std::size_t borrow_threshold = default_borrow_threshold )
+        : basic_writev_writer(settings{fd, buffer_size, borrow_threshold})
+    {
+    }
+
+    basic_writev_writer(const basic_writev_writer&) = delete;
+    basic_writev_writer(basic_writev_writer&&) = delete;
+
+    void recycle() noexcept override
+    {
+        if (this->good()) {
+            close_segment_();
+            this->set_good(flush_());
+        }
+        segments_count_ = 0;
+        segment_begin_ = buf_.get();
+        this->set_pointer(buf_.get());
+        this->set_end(buf_.get() + buf_size_);
+    }
+
+    bool borrow(const CharT* str, std::size_t len) noexcept override
+    {
+        if (len < borrow_threshold_ || ! this->good()) {
+            return false;
+        }
+        close_segment_();
+        segments_[segments_count_++] = strf::detail::make_iovec(str, len);
+        if (segments_count_ + 1 >= max_segments_) {
+            // keep room for the segment that close_segment_ may add
+            this->set_good(flush_());
+            segment_begin_ = buf_.get();
+            this->set_pointer(buf_.get());
+        }
+        return true;
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    result finish() noexcept
+    {
+        bool g = this->good();
+        this->set_good(false);
+        if (g) {
+            close_segment_();
+            g = flush_();
+        }
+        segment_begin_ = buf_.get();
+        this->set_pointer(buf_.get());
+        return {count_, g};
+    }
+
+private:
+
+    void close_segment_() noexcept
+    {
+        auto p = this->pointer();
+        if (p != segment_begin_) {
+            STRF_ASSERT(segments_count_ < max_segments_);
+            segments_[segments_count_++]
+                = strf::detail::make_iovec(segment_begin_, p - segment_begin_);
+            segment_begin_ = p;
+        }
+    }
+
+    bool flush_() noexcept
+    {
+        std::size_t bytes = 0;
+        for (int i = 0; i < segments_count_; ++i) {
+            bytes += segments_[i].iov_len;
+        }
+        auto written = strf::detail::writev_all(fd_, segments_, segments_count_);
+        segments_count_ = 0;
+        count_ += written / sizeof(CharT);
+        return written == bytes;
+    }
+
+    static constexpr int max_segments_ = 64;
+
+    int fd_;
+    std::unique_ptr<CharT[]> buf_;
+    std::size_t buf_size_;
+    std::size_t borrow_threshold_;
+    std::size_t count_ = 0;
+    CharT* segment_begin_ = nullptr;
+    int segments_count_ = 0;
+    ::iovec segments_[max_segments_];
+};
+
+using iovec_writer = basic_iovec_writer<char>;
+using writev_writer = basic_writev_writer<char>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_iovec_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_iovec_writer<CharT>;
+    using finish_type = typename outbuff_type::result;
+
+    constexpr basic_iovec_writer_creator
+        ( std::size_t chunk_size, std::size_t borrow_threshold ) noexcept
+        : settings_{chunk_size, borrow_threshold}
+    {
+    }
+
+    constexpr basic_iovec_writer_creator
+        (const basic_iovec_writer_creator&) = default;
+
+    typename outbuff_type::settings create() const noexcept
+    {
+        return settings_;
+    }
+
+private:
+
+    typename outbuff_type::settings settings_;
+};
+
+template <typename CharT>
+class basic_writev_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_writev_writer<CharT>;
+    using finish_type = typename outbuff_type::result;
+
+    constexpr basic_writev_writer_creator
+        ( int fd, std::size_t buffer_size, std::size_t borrow_threshold ) noexcept
+        : settings_{fd, buffer_size, borrow_threshold}
+    {
+    }
+
+    constexpr basic_writev_writer_creator
+        (const basic_writev_writer_creator&) = default;
+
+    typename outbuff_type::settings create() const noexcept
+    {
+        return settings_;
+    }
+
+private:
+
+    typename outbuff_type::settings settings_;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_iovec
+    ( std::size_t chunk_size = strf::basic_iovec_writer<CharT>::default_chunk_size
+    , std::size_t borrow_threshold = strf::basic_iovec_writer<CharT>::default_borrow_threshold )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_iovec_writer_creator<CharT> >
+        (chunk_size, borrow_threshold);
+}
+
+// finish() is called at the end of the print expression, while the
+// borrowed arguments are still alive. See basic_writev_writer for
+// when the writer is used directly.
+template <typename CharT = char>
+inline auto to_fd_writev
+    ( int fd
+    , std::size_t buffer_size = strf::basic_writev_writer<CharT>::default_buffer_size
+    , std::size_t borrow_threshold = strf::basic_writev_writer<CharT>::default_borrow_threshold )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_writev_writer_creator<CharT> >
+        (fd, buffer_size, borrow_threshold);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_IOVEC_HPP
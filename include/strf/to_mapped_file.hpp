@@ -0,0 +1,223 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_MAPPED_FILE_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_MAPPED_FILE_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#else
+#error "<strf/to_mapped_file.hpp> requires a POSIX system"
+#endif
+
+namespace strf {
+
+// Writes directly into the pages of a file mapped with mmap. The file
+// is enlarged with posix_fallocate ( and the mapping with mremap, when
+// available ) each time the mapped area is full, and in the end it is
+// truncated to the length of what has been written.
+// The space is reserved rather than left sparse, so that a full disk
+// turns this object "bad" instead of raising SIGBUS on a store.
+// The previous content of the file, if any, is overwritten.
+template <typename CharT>
+class basic_mapped_file_writer final: public strf::basic_outbuff_noexcept<CharT>
+{
+public:
+
+    static constexpr std::size_t default_initial_size = (1 << 20) / sizeof(CharT);
+
+    struct settings
+    {
+        int fd;
+        std::size_t initial_size;
+    };
+
+    explicit basic_mapped_file_writer(settings s) noexcept
+        : strf::basic_outbuff_noexcept<CharT>(nullptr, nullptr)
+        , fd_(s.fd)
+    {
+        constexpr std::size_t min_size = strf::min_space_after_recycle<CharT>();
+        auto size = s.initial_size < min_size ? min_size : s.initial_size;
+        if (resize_file_(0) && reserve_file_(size * sizeof(CharT))) {
+            void* addr = ::mmap( nullptr, size * sizeof(CharT)
+                               , PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0 );
+            if (addr != MAP_FAILED) {
+                map_ = static_cast<CharT*>(addr);
+                map_size_ = size;
+                this->set_pointer(map_);
+                this->set_end(map_ + map_size_);
+                return;
+            }
+        }
+        set_bad_();
+    }
+
+    explicit basic_mapped_file_writer
+        ( int fd, std::size_t initial_size = default_initial_size ) noexcept
+        : basic_mapped_file_writer(settings{fd, initial_size})
+    {
+    }
+
+    basic_mapped_file_writer(const basic_mapped_file_writer&) = delete;
+    basic_mapped_file_writer(basic_mapped_file_writer&&) = delete;
+
+    ~basic_mapped_file_writer()
+    {
+        if (map_ != nullptr) {
+            ::munmap(map_, map_size_ * sizeof(CharT));
+        }
+    }
+
+    void recycle() noexcept override
+    {
+        if ( ! this->good()) {
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+            return;
+        }
+        count_ = this->pointer() - map_;
+        auto new_size = map_size_ * 2;
+        if ( ! reserve_file_(new_size * sizeof(CharT))) {
+            set_bad_();
+            return;
+        }
+        void* addr = remap_(new_size);
+        if (addr == MAP_FAILED) {
+            set_bad_();
+            return;
+        }
+        map_ = static_cast<CharT*>(addr);
+        map_size_ = new_size;
+        this->set_pointer(map_ + count_);
+        this->set_end(map_ + map_size_);
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    result finish() noexcept
+    {
+        bool g = this->good();
+        if (g) {
+            count_ = this->pointer() - map_;
+            set_bad_();
+        }
+        if (map_ != nullptr) {
+            ::munmap(map_, map_size_ * sizeof(CharT));
+            map_ = nullptr;
+            map_size_ = 0;
+        }
+        g = resize_file_(count_ * sizeof(CharT)) && g;
+        return {count_, g};
+    }
+
+private:
+
+    bool resize_file_(std::size_t bytes) noexcept
+    {
+        return 0 == ::ftruncate(fd_, static_cast<off_t>(bytes));
+    }
+
+    bool reserve_file_(std::size_t bytes) noexcept
+    {
+#if defined(_POSIX_ADVISORY_INFO) && _POSIX_ADVISORY_INFO >= 0
+        int err = ::posix_fallocate(fd_, 0, static_cast<off_t>(bytes));
+        if (err != EINVAL && err != EOPNOTSUPP) {
+            return err == 0;
+        }
+        // not supported by the file system
+#endif
+        return resize_file_(bytes);
+    }
+
+    void* remap_(std::size_t new_size) noexcept
+    {
+#if defined(MREMAP_MAYMOVE)
+        return ::mremap( map_, map_size_ * sizeof(CharT)
+                       , new_size * sizeof(CharT), MREMAP_MAYMOVE );
+#else
+        ::munmap(map_, map_size_ * sizeof(CharT));
+        map_ = nullptr;
+        map_size_ = 0;
+        return ::mmap( nullptr, new_size * sizeof(CharT)
+                     , PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0 );
+#endif
+    }
+
+    void set_bad_() noexcept
+    {
+        this->set_good(false);
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+    }
+
+    int fd_;
+    CharT* map_ = nullptr;
+    std::size_t map_size_ = 0;
+    std::size_t count_ = 0;
+};
+
+using mapped_file_writer = basic_mapped_file_writer<char>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_mapped_file_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_mapped_file_writer<CharT>;
+    using sized_outbuff_type = outbuff_type;
+    using finish_type = typename outbuff_type::result;
+
+    constexpr basic_mapped_file_writer_creator
+        ( int fd, std::size_t initial_size ) noexcept
+        : fd_(fd)
+        , initial_size_(initial_size)
+    {
+    }
+
+    constexpr basic_mapped_file_writer_creator
+        (const basic_mapped_file_writer_creator&) = default;
+
+    typename outbuff_type::settings create() const noexcept
+    {
+        return {fd_, initial_size_};
+    }
+    typename outbuff_type::settings create(std::size_t size) const noexcept
+    {
+        return {fd_, size};
+    }
+
+private:
+
+    int fd_;
+    std::size_t initial_size_;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_mapped_file
+    ( int fd
+    , std::size_t initial_size = strf::basic_mapped_file_writer<CharT>::default_initial_size )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_mapped_file_writer_creator<CharT> >
+        (fd, initial_size);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_MAPPED_FILE_HPP
@@ -0,0 +1,335 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_RING_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_RING_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_fd.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace strf {
+
+template <typename CharT>
+class basic_ring_writer;
+
+// A bounded ring of fixed-size slots, where many producer threads
+// write records through basic_ring_writer, and a single consumer
+// thread reads them with drain() or drain_to_fd(). Producers never
+// block: when there is no free slot, the record is dropped.
+//
+// Slots are reserved with the algorithm of Dmitry Vyukov's bounded
+// MPMC queue: each slot has a sequence number that tells whether it
+// is free for the producer of a given position, or ready for the
+// consumer. A record larger than a slot occupies a chain of slots,
+// which the consumer joins before passing the record on.
+template <typename CharT>
+class basic_ring
+{
+public:
+
+    static constexpr std::size_t default_slot_size = 256 / sizeof(CharT);
+
+    explicit basic_ring
+        ( std::size_t slots_count
+        , std::size_t slot_size = default_slot_size )
+        : slots_(new slot_[slots_count])
+        , data_(new CharT[slots_count * slot_size])
+        , slots_count_(slots_count)
+        , slot_size_(slot_size)
+    {
+        STRF_ASSERT(slot_size_ >= strf::min_space_after_recycle<CharT>());
+        for (std::size_t i = 0; i < slots_count_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    basic_ring(const basic_ring&) = delete;
+    basic_ring(basic_ring&&) = delete;
+
+    std::size_t slot_size() const noexcept
+    {
+        return slot_size_;
+    }
+
+    // Number of records that have been dropped, entirely or partially,
+    // because the ring was full.
+    std::size_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Must be called by a single thread. Calls f(const CharT*, std::size_t)
+    // for each complete record available, in order of publication.
+    // Returns the number of records passed to f.
+    template <typename F>
+    std::size_t drain(F&& f)
+    {
+        std::size_t records = 0;
+        for(;;) {
+            auto pos = read_pos_;
+            slot_& s = slots_[pos % slots_count_];
+            if (s.seq.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            const CharT* data = slot_data_(pos);
+            if (s.record == pos && s.last) {
+                f(data, s.len);
+                ++records;
+            } else {
+                auto& str = pending_record_(s.record);
+                str.append(data, s.len);
+                if (s.last) {
+                    f(str.data(), str.size());
+                    ++records;
+                    remove_pending_record_(s.record);
+                }
+            }
+            s.seq.store(pos + slots_count_, std::memory_order_release);
+            read_pos_ = pos + 1;
+        }
+        return records;
+    }
+
+    // Must be called by a single thread. Writes all complete records
+    // available into the file descriptor.
+    typename strf::basic_fd_writer<CharT>::result drain_to_fd(int fd)
+    {
+        strf::basic_fd_writer<CharT> writer(fd);
+        drain([&writer](const CharT* str, std::size_t len) {
+                  strf::write(writer, str, len);
+              });
+        return writer.finish();
+    }
+
+private:
+
+    friend class strf::basic_ring_writer<CharT>;
+
+    struct slot_
+    {
+        std::atomic<std::size_t> seq;
+        std::size_t len;
+        std::size_t record;
+        bool last;
+    };
+
+    CharT* slot_data_(std::size_t pos) const noexcept
+    {
+        return data_.get() + (pos % slots_count_) * slot_size_;
+    }
+
+    bool reserve_(std::size_t& pos) noexcept
+    {
+        pos = write_pos_.load(std::memory_order_relaxed);
+        for(;;) {
+            slot_& s = slots_[pos % slots_count_];
+            auto seq = s.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (write_pos_.compare_exchange_weak
+                        ( pos, pos + 1, std::memory_order_relaxed )) {
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = write_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish_
+        ( std::size_t pos, std::size_t len
+        , std::size_t record, bool last ) noexcept
+    {
+        slot_& s = slots_[pos % slots_count_];
+        s.len = len;
+        s.record = record;
+        s.last = last;
+        s.seq.store(pos + 1, std::memory_order_release);
+    }
+
+    void add_dropped_() noexcept
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::basic_string<CharT>& pending_record_(std::size_t record)
+    {
+        for (auto& p: pending_) {
+            if (p.first == record) {
+                return p.second;
+            }
+        }
+        pending_.emplace_back(record, std::basic_string<CharT>());
+        return pending_.back().second;
+    }
+
+    void remove_pending_record_(std::size_t record) noexcept
+    {
+        for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+            if (it->first == record) {
+                pending_.erase(it);
+                return;
+            }
+        }
+    }
+
+    std::unique_ptr<slot_[]> slots_;
+    std::unique_ptr<CharT[]> data_;
+    std::size_t slots_count_;
+    std::size_t slot_size_;
+    std::atomic<std::size_t> write_pos_{0};
+    std::atomic<std::size_t> dropped_{0};
+
+    // used only by the consumer
+    std::size_t read_pos_ = 0;
+    std::vector<std::pair<std::size_t, std::basic_string<CharT>>> pending_;
+};
+
+// Writes one record directly into the slots of a basic_ring.
+// recycle() publishes the current slot and reserves the next one,
+// without blocking. If there is no free slot, the record is truncated
+// there and the object turns bad. finish() publishes the last slot.
+template <typename CharT>
+class basic_ring_writer final: public strf::basic_outbuff_noexcept<CharT>
+{
+public:
+
+    explicit basic_ring_writer(strf::basic_ring<CharT>& ring) noexcept
+        : strf::basic_outbuff_noexcept<CharT>(nullptr, nullptr)
+        , ring_(ring)
+    {
+        if (ring_.reserve_(pos_)) {
+            owns_slot_ = true;
+            record_ = pos_;
+            this->set_pointer(ring_.slot_data_(pos_));
+            this->set_end(this->pointer() + ring_.slot_size());
+        } else {
+            ring_.add_dropped_();
+            set_bad_();
+        }
+    }
+
+    basic_ring_writer(const basic_ring_writer&) = delete;
+    basic_ring_writer(basic_ring_writer&&) = delete;
+
+    ~basic_ring_writer()
+    {
+        if (owns_slot_) {
+            publish_(true);
+        }
+    }
+
+    void recycle() noexcept override
+    {
+        if ( ! this->good()) {
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+            return;
+        }
+        std::size_t next_pos;
+        if (ring_.reserve_(next_pos)) {
+            publish_(false);
+            pos_ = next_pos;
+            owns_slot_ = true;
+            this->set_pointer(ring_.slot_data_(pos_));
+            this->set_end(this->pointer() + ring_.slot_size());
+        } else {
+            publish_(true);
+            ring_.add_dropped_();
+            set_bad_();
+        }
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    result finish() noexcept
+    {
+        bool g = this->good();
+        if (g) {
+            publish_(true);
+            set_bad_();
+        }
+        return {count_, g};
+    }
+
+private:
+
+    void publish_(bool last) noexcept
+    {
+        std::size_t len = this->pointer() - ring_.slot_data_(pos_);
+        count_ += len;
+        owns_slot_ = false;
+        ring_.publish_(pos_, len, record_, last);
+    }
+
+    void set_bad_() noexcept
+    {
+        this->set_good(false);
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+    }
+
+    strf::basic_ring<CharT>& ring_;
+    std::size_t pos_ = 0;
+    std::size_t record_ = 0;
+    std::size_t count_ = 0;
+    bool owns_slot_ = false;
+};
+
+using ring = basic_ring<char>;
+using ring_writer = basic_ring_writer<char>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_ring_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_ring_writer<CharT>;
+    using finish_type = typename outbuff_type::result;
+
+    constexpr explicit basic_ring_writer_creator(strf::basic_ring<CharT>& r) noexcept
+        : ring_(&r)
+    {
+    }
+
+    constexpr basic_ring_writer_creator
+        (const basic_ring_writer_creator&) = default;
+
+    strf::basic_ring<CharT>& create() const noexcept
+    {
+        return *ring_;
+    }
+
+private:
+
+    strf::basic_ring<CharT>* ring_;
+};
+
+} // namespace detail
+
+template <typename CharT>
+inline auto to_ring(strf::basic_ring<CharT>& r)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_ring_writer_creator<CharT> >
+        (r);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_RING_HPP
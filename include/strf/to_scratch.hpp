@@ -0,0 +1,185 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_SCRATCH_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_SCRATCH_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <memory>
+
+namespace strf {
+
+namespace detail {
+
+template <typename CharT>
+struct scratch_buffer
+{
+    std::unique_ptr<CharT[]> data;
+    std::size_t size = 0;
+};
+
+template <typename CharT>
+inline strf::detail::scratch_buffer<CharT>& thread_scratch_buffer() noexcept
+{
+    static thread_local strf::detail::scratch_buffer<CharT> buf;
+    return buf;
+}
+
+} // namespace detail
+
+// Writes into a buffer that belongs to the current thread and that is
+// reused by all basic_scratch_writer<CharT> objects of that thread.
+// The buffer only grows, so after some calls there is no allocation
+// anymore. The string view returned by finish() is only valid until
+// another basic_scratch_writer<CharT> is created in the same thread.
+// In particular, it must not be passed as an argument to be printed
+// by another scratch writer of the same character type: this writer
+// overwrites the characters that the view refers to, and may even
+// free them when the buffer grows. Copy it into a string first.
+template <typename CharT>
+class basic_scratch_writer final: public strf::basic_outbuff<CharT>
+{
+public:
+
+#if defined(STRF_HAS_STD_STRING_VIEW)
+    using result = std::basic_string_view<CharT>;
+#else
+    using result = strf::detail::simple_string_view<CharT>;
+#endif
+
+    static constexpr std::size_t min_buffer_size = 512 / sizeof(CharT);
+
+    explicit basic_scratch_writer(std::size_t capacity = 0)
+        : strf::basic_outbuff<CharT>(nullptr, nullptr)
+        , buf_(strf::detail::thread_scratch_buffer<CharT>())
+    {
+        if (buf_.size < capacity || buf_.size < min_buffer_size) {
+            auto size = capacity < min_buffer_size ? min_buffer_size : capacity;
+            buf_.data.reset();
+            buf_.size = 0;
+            buf_.data.reset(new CharT[size]);
+            buf_.size = size;
+        }
+        this->set_pointer(buf_.data.get());
+        this->set_end(buf_.data.get() + buf_.size);
+    }
+
+    basic_scratch_writer(const basic_scratch_writer&) = delete;
+    basic_scratch_writer(basic_scratch_writer&&) = delete;
+
+    void recycle() override
+    {
+        if (this->good()) {
+            std::size_t len = this->pointer() - buf_.data.get();
+            std::size_t new_size = buf_.size * 2;
+            this->set_good(false);
+            std::unique_ptr<CharT[]> new_data(new CharT[new_size]);
+            strf::detail::copy_n(buf_.data.get(), len, new_data.get());
+            buf_.data = std::move(new_data);
+            buf_.size = new_size;
+            this->set_good(true);
+            this->set_pointer(buf_.data.get() + len);
+            this->set_end(buf_.data.get() + new_size);
+        } else {
+            discard_unused_();
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        }
+    }
+
+    result finish()
+    {
+        discard_unused_();
+        this->set_good(false);
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        return {buf_.data.get(), len_};
+    }
+
+private:
+
+    void discard_unused_()
+    {
+        if ( ! discarding_) {
+            len_ = this->pointer() - buf_.data.get();
+            discarding_ = true;
+        }
+    }
+
+    strf::detail::scratch_buffer<CharT>& buf_;
+    std::size_t len_ = 0;
+    bool discarding_ = false; // whether no longer writing into buf_
+};
+
+using scratch_writer = basic_scratch_writer<char>;
+using u16scratch_writer = basic_scratch_writer<char16_t>;
+using u32scratch_writer = basic_scratch_writer<char32_t>;
+using wscratch_writer = basic_scratch_writer<wchar_t>;
+
+#if defined(__cpp_char8_t)
+
+using u8scratch_writer = basic_scratch_writer<char8_t>;
+
+#endif
+
+namespace detail {
+
+template <typename CharT>
+class basic_scratch_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_scratch_writer<CharT>;
+    using sized_outbuff_type = outbuff_type;
+    using finish_type = typename outbuff_type::result;
+
+    std::size_t create() const noexcept
+    {
+        return 0;
+    }
+    std::size_t create(std::size_t size) const noexcept
+    {
+        return size;
+    }
+};
+
+} // namespace detail
+
+// The result of a to_basic_scratch<CharT> expression refers to the same
+// buffer that the next one writes into. So don't pass it as an argument
+// of the next one, as in to_scratch("a", to_scratch("b")). See
+// basic_scratch_writer.
+template <typename CharT = char>
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_scratch_writer_creator<CharT> >
+    to_basic_scratch {};
+
+#if defined(__cpp_char8_t)
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_scratch_writer_creator<char8_t> >
+    to_u8scratch {};
+
+#endif
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_scratch_writer_creator<char> >
+    to_scratch {};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_scratch_writer_creator<char16_t> >
+    to_u16scratch {};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_scratch_writer_creator<char32_t> >
+    to_u32scratch {};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_scratch_writer_creator<wchar_t> >
+    to_wscratch {};
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_SCRATCH_HPP
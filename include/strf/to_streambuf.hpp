@@ -15,15 +15,44 @@ class basic_streambuf_writer final: public strf::basic_outbuff<CharT>
 {
 public:
 
+    struct settings
+    {
+        std::basic_streambuf<CharT, Traits>& dest;
+        CharT* buffer;
+        std::size_t buffer_size;
+    };
+
     explicit basic_streambuf_writer(std::basic_streambuf<CharT, Traits>& d)
-        : strf::basic_outbuff<CharT>(buf_, buf_size_)
+        : strf::basic_outbuff<CharT>(default_buf_, default_buf_size_)
         , dest_(d)
+        , buf_(default_buf_)
     {
     }
     explicit basic_streambuf_writer(std::basic_streambuf<CharT, Traits>* d)
-        : strf::basic_outbuff<CharT>(buf_, buf_size_)
+        : strf::basic_outbuff<CharT>(default_buf_, default_buf_size_)
         , dest_(*d)
+        , buf_(default_buf_)
+    {
+    }
+    basic_streambuf_writer
+        ( std::basic_streambuf<CharT, Traits>& d
+        , CharT* buffer
+        , std::size_t buffer_size )
+        : strf::basic_outbuff<CharT>(buffer, buffer_size)
+        , dest_(d)
+        , buf_(buffer)
+    {
+        STRF_ASSERT(buffer_size >= strf::min_space_after_recycle<CharT>());
+    }
+    explicit basic_streambuf_writer(settings s)
+        : strf::basic_outbuff<CharT>
+            ( s.buffer ? s.buffer : default_buf_
+            , s.buffer ? s.buffer_size : default_buf_size_ )
+        , dest_(s.dest)
+        , buf_(s.buffer ? s.buffer : default_buf_)
     {
+        STRF_ASSERT( s.buffer == nullptr
+                  || s.buffer_size >= strf::min_space_after_recycle<CharT>() );
     }
 
     basic_streambuf_writer() = delete;
@@ -70,9 +99,10 @@ private:
 
     std::basic_streambuf<CharT, Traits>& dest_;
     std::streamsize count_ = 0;
-    static constexpr std::size_t buf_size_
+    CharT* buf_;
+    static constexpr std::size_t default_buf_size_
         = strf::min_space_after_recycle<CharT>();
-    CharT buf_[buf_size_];
+    CharT default_buf_[default_buf_size_];
 };
 
 using streambuf_writer  = strf::basic_streambuf_writer<char>;
@@ -80,6 +110,157 @@ using wstreambuf_writer = strf::basic_streambuf_writer<wchar_t>;
 
 namespace detail {
 
+// Gives access to the protected put area members of any
+// std::basic_streambuf object, through pointers to members.
+template <typename CharT, typename Traits>
+class streambuf_put_area_access: public std::basic_streambuf<CharT, Traits>
+{
+    using streambuf_type_ = std::basic_streambuf<CharT, Traits>;
+
+public:
+
+    static CharT* get_pbase(streambuf_type_& sb)
+    {
+        return (sb.*&streambuf_put_area_access::pbase)();
+    }
+    static CharT* get_pptr(streambuf_type_& sb)
+    {
+        return (sb.*&streambuf_put_area_access::pptr)();
+    }
+    static CharT* get_epptr(streambuf_type_& sb)
+    {
+        return (sb.*&streambuf_put_area_access::epptr)();
+    }
+    static void do_pbump(streambuf_type_& sb, std::size_t count)
+    {
+        constexpr std::size_t max_step = 0x7FFFFFFF;
+        for(; count > max_step; count -= max_step) {
+            (sb.*&streambuf_put_area_access::pbump)(static_cast<int>(max_step));
+        }
+        (sb.*&streambuf_put_area_access::pbump)(static_cast<int>(count));
+    }
+};
+
+} // namespace detail
+
+// Writes directly into the put area of the streambuf,
+// ( i.e. the range [pptr(), epptr()) ) whenever it has at least
+// min_space_after_recycle<CharT>() characters. Otherwise, it
+// uses an internal buffer whose content is passed to sputn.
+// The streambuf must not be used by anything else while
+// this object is alive.
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+class basic_streambuf_direct_writer final: public strf::basic_outbuff<CharT>
+{
+    using access_ = strf::detail::streambuf_put_area_access<CharT, Traits>;
+
+public:
+
+    explicit basic_streambuf_direct_writer(std::basic_streambuf<CharT, Traits>& d)
+        : strf::basic_outbuff<CharT>(buf_, buf_size_)
+        , dest_(d)
+    {
+        select_area_();
+    }
+    explicit basic_streambuf_direct_writer(std::basic_streambuf<CharT, Traits>* d)
+        : basic_streambuf_direct_writer(*d)
+    {
+    }
+
+    basic_streambuf_direct_writer() = delete;
+
+    basic_streambuf_direct_writer(const basic_streambuf_direct_writer&) = delete;
+    basic_streambuf_direct_writer(basic_streambuf_direct_writer&&) = delete;
+
+    ~basic_streambuf_direct_writer()
+    {
+    }
+
+    void recycle() override
+    {
+        if (this->good()) {
+            this->set_good(false);
+            bool g = commit_();
+            this->set_good(g);
+            if (g) {
+                select_area_();
+                return;
+            }
+        }
+        this->set_pointer(buf_);
+        this->set_end(buf_ + buf_size_);
+        in_put_area_ = false;
+    }
+
+    struct result
+    {
+        std::streamsize count;
+        bool success;
+    };
+
+    result finish()
+    {
+        bool g = this->good();
+        this->set_good(false);
+        if (g) {
+            g = commit_();
+        }
+        this->set_pointer(buf_);
+        this->set_end(buf_ + buf_size_);
+        in_put_area_ = false;
+        return {count_, g};
+    }
+
+private:
+
+    bool commit_()
+    {
+        if (in_put_area_) {
+            auto count = this->pointer() - access_::get_pptr(dest_);
+            access_::do_pbump(dest_, count);
+            count_ += count;
+            return true;
+        }
+        std::streamsize count = this->pointer() - buf_;
+        auto count_inc = dest_.sputn(buf_, count);
+        count_ += count_inc;
+        return count_inc == count;
+    }
+
+    void select_area_()
+    {
+        constexpr std::ptrdiff_t min_space = strf::min_space_after_recycle<CharT>();
+        if (access_::get_epptr(dest_) - access_::get_pptr(dest_) < min_space) {
+            if (access_::get_pbase(dest_) != access_::get_pptr(dest_)) {
+                // give the streambuf the chance to flush its put area
+                dest_.pubsync();
+            }
+        }
+        auto p = access_::get_pptr(dest_);
+        auto e = access_::get_epptr(dest_);
+        in_put_area_ = (e - p >= min_space);
+        if (in_put_area_) {
+            this->set_pointer(p);
+            this->set_end(e);
+        } else {
+            this->set_pointer(buf_);
+            this->set_end(buf_ + buf_size_);
+        }
+    }
+
+    std::basic_streambuf<CharT, Traits>& dest_;
+    std::streamsize count_ = 0;
+    bool in_put_area_ = false;
+    static constexpr std::size_t buf_size_
+        = strf::min_space_after_recycle<CharT>();
+    CharT buf_[buf_size_];
+};
+
+using streambuf_direct_writer  = strf::basic_streambuf_direct_writer<char>;
+using wstreambuf_direct_writer = strf::basic_streambuf_direct_writer<wchar_t>;
+
+namespace detail {
+
 template <typename CharT, typename Traits>
 class basic_streambuf_writer_creator
 {
@@ -92,12 +273,49 @@ public:
 
     explicit basic_streambuf_writer_creator
         ( std::basic_streambuf<CharT, Traits>& dest )
-        : dest_(dest)
+        : settings_{dest, nullptr, 0}
+    {
+    }
+
+    basic_streambuf_writer_creator
+        ( std::basic_streambuf<CharT, Traits>& dest
+        , CharT* buffer
+        , std::size_t buffer_size )
+        : settings_{dest, buffer, buffer_size}
     {
     }
 
     basic_streambuf_writer_creator(const basic_streambuf_writer_creator&) = default;
 
+    typename outbuff_type::settings create() const noexcept
+    {
+        return settings_;
+    }
+
+private:
+
+    typename outbuff_type::settings settings_;
+};
+
+
+template <typename CharT, typename Traits>
+class basic_streambuf_direct_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_streambuf_direct_writer<CharT, Traits>;
+    using finish_type = typename outbuff_type::result;
+
+    explicit basic_streambuf_direct_writer_creator
+        ( std::basic_streambuf<CharT, Traits>& dest )
+        : dest_(dest)
+    {
+    }
+
+    basic_streambuf_direct_writer_creator
+        (const basic_streambuf_direct_writer_creator&) = default;
+
     std::basic_streambuf<CharT, Traits>& create() const noexcept
     {
         return dest_;
@@ -108,7 +326,6 @@ private:
     std::basic_streambuf<CharT, Traits>& dest_;
 };
 
-
 } // namespace detail
 
 
@@ -127,6 +344,54 @@ inline auto to( std::basic_streambuf<CharT, Traits>* dest )
     return strf::to(*dest);
 }
 
+template <typename CharT, typename Traits>
+inline auto to( std::basic_streambuf<CharT, Traits>& dest
+              , CharT* buffer
+              , std::size_t buffer_size )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_streambuf_writer_creator<CharT, Traits> >
+        (dest, buffer, buffer_size);
+}
+
+template <typename CharT, typename Traits, std::size_t N>
+inline auto to( std::basic_streambuf<CharT, Traits>& dest
+              , CharT (&buffer)[N] )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_streambuf_writer_creator<CharT, Traits> >
+        (dest, buffer, N);
+}
+
+template <typename CharT, typename Traits>
+inline auto to( std::basic_streambuf<CharT, Traits>* dest
+              , CharT* buffer
+              , std::size_t buffer_size )
+{
+    return strf::to(*dest, buffer, buffer_size);
+}
+
+template <typename CharT, typename Traits, std::size_t N>
+inline auto to( std::basic_streambuf<CharT, Traits>* dest
+              , CharT (&buffer)[N] )
+{
+    return strf::to(*dest, buffer);
+}
+
+template <typename CharT, typename Traits>
+inline auto to_put_area( std::basic_streambuf<CharT, Traits>& dest )
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_streambuf_direct_writer_creator<CharT, Traits> >
+        (dest);
+}
+
+template <typename CharT, typename Traits>
+inline auto to_put_area( std::basic_streambuf<CharT, Traits>* dest )
+{
+    return strf::to_put_area(*dest);
+}
+
 } // namespace strf
 
 #endif  // STRF_DETAIL_OUTPUT_TYPES_STD_STREAMBUF_HPP
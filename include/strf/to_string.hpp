@@ -21,17 +21,28 @@ class basic_string_appender final: public strf::basic_outbuff<CharT>
 public:
 
     basic_string_appender(string_type_& str)
-        : strf::basic_outbuff<CharT>(buf_, buf_size_)
+        : strf::basic_outbuff<CharT>(default_buf_, default_buf_size_)
         , str_(str)
+        , buf_(default_buf_)
     {
     }
     basic_string_appender( string_type_& str
                          , std::size_t size )
-        : strf::basic_outbuff<CharT>(buf_, buf_size_)
+        : strf::basic_outbuff<CharT>(default_buf_, default_buf_size_)
         , str_(str)
+        , buf_(default_buf_)
     {
         str_.reserve(size);
     }
+    basic_string_appender( string_type_& str
+                         , CharT* buffer
+                         , std::size_t buffer_size )
+        : strf::basic_outbuff<CharT>(buffer, buffer_size)
+        , str_(str)
+        , buf_(buffer)
+    {
+        STRF_ASSERT(buffer_size >= strf::min_space_after_recycle<CharT>());
+    }
 
     basic_string_appender(const basic_string_appender&) = delete;
     basic_string_appender(basic_string_appender&&) = delete;
@@ -59,11 +70,24 @@ public:
 private:
 
     string_type_& str_;
-    static constexpr std::size_t buf_size_
+    CharT* buf_;
+    static constexpr std::size_t default_buf_size_
         = strf::min_space_after_recycle<CharT>();
-    CharT buf_[buf_size_];
+    CharT default_buf_[default_buf_size_];
 };
 
+namespace detail {
+
+// Same as str.data(), which only returns a pointer to const before
+// C++17. Unlike &*str.begin(), it is also valid when str is empty.
+template <typename CharT, typename Traits, typename Allocator>
+inline CharT* string_data(std::basic_string<CharT, Traits, Allocator>& str) noexcept
+{
+    return &str[0];
+}
+
+} // namespace detail
+
 template < typename CharT
          , typename Traits = std::char_traits<CharT>
          , typename Allocator = std::allocator<CharT> >
@@ -74,8 +98,16 @@ class basic_string_maker final: public strf::basic_outbuff<CharT>
 public:
 
     basic_string_maker()
-        : strf::basic_outbuff<CharT>(buf_, buf_size_)
+        : strf::basic_outbuff<CharT>(nullptr, nullptr)
     {
+        // Start with whatever capacity the empty string already
+        // has ( the small string buffer, in most implementations ),
+        // but with at least min_space_after_recycle characters.
+        constexpr std::size_t min_buff_size = strf::min_space_after_recycle<CharT>();
+        str_.resize(strf::detail::max<std::size_t>(str_.capacity(), min_buff_size));
+        auto* data = strf::detail::string_data(str_);
+        this->set_pointer(data);
+        this->set_end(data + str_.size());
     }
 
     basic_string_maker(strf::tag<void>)
@@ -90,31 +122,44 @@ public:
 
     void recycle() override
     {
-        auto * p = this->pointer();
-        this->set_pointer(buf_);
         if (this->good()) {
+            std::size_t original_size = this->pointer() - strf::detail::string_data(str_);
+            constexpr std::size_t min_buff_size = strf::min_space_after_recycle<CharT>();
+            auto append_size = strf::detail::max<std::size_t>(original_size, min_buff_size);
             this->set_good(false);
-            str_.append(buf_, p);
+            str_.resize(original_size + append_size);
             this->set_good(true);
+            auto* data = strf::detail::string_data(str_);
+            this->set_pointer(data + original_size);
+            this->set_end(data + str_.size());
+        } else {
+            discard_unused_();
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
         }
     }
 
     string_type_ finish()
     {
-        auto * p = this->pointer();
-        if (this->good()) {
-            this->set_good(false);
-            str_.append(buf_, p);
-        }
+        discard_unused_();
+        this->set_good(false);
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
         return std::move(str_);
     }
 
 private:
 
+    void discard_unused_()
+    {
+        if ( ! discarding_) {
+            str_.resize(this->pointer() - strf::detail::string_data(str_));
+            discarding_ = true;
+        }
+    }
+
     string_type_ str_;
-    static constexpr std::size_t buf_size_
-        = strf::min_space_after_recycle<CharT>();
-    CharT buf_[buf_size_];
+    bool discarding_ = false; // whether no longer writing into str_
 };
 
 template < typename CharT
@@ -127,10 +172,12 @@ public:
 
     explicit basic_sized_string_maker(std::size_t count)
         : strf::basic_outbuff<CharT>(nullptr, nullptr)
-        , str_(count, (CharT)0)
     {
-        this->set_pointer(&*str_.begin());
-        this->set_end(&*str_.begin() + count);
+        constexpr std::size_t min_buff_size = strf::min_space_after_recycle<CharT>();
+        str_.resize(strf::detail::max<std::size_t>(count, min_buff_size));
+        auto* data = strf::detail::string_data(str_);
+        this->set_pointer(data);
+        this->set_end(data + str_.size());
     }
 
     basic_sized_string_maker(const basic_sized_string_maker&) = delete;
@@ -141,9 +188,10 @@ public:
         std::size_t original_size = this->pointer() - str_.data();
         constexpr std::size_t min_buff_size = strf::min_space_after_recycle<CharT>();
         auto append_size = strf::detail::max<std::size_t>(original_size, min_buff_size);
-        str_.append(append_size, (CharT)0);
-        this->set_pointer(&*str_.begin() + original_size);
-        this->set_end(&*str_.begin() + original_size + append_size);
+        str_.resize(original_size + append_size);
+        auto* data = strf::detail::string_data(str_);
+        this->set_pointer(data + original_size);
+        this->set_end(data + original_size + append_size);
     }
 
     std::basic_string<CharT, Traits, Allocator> finish()
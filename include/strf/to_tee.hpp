@@ -0,0 +1,145 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_TEE_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_TEE_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf.hpp>
+#include <array>
+
+namespace strf {
+
+// Writes into an internal buffer, and copies its content into each of the
+// downstream outbuffs on recycle() and on finish(). So the content is
+// formatted only once, no matter the number of destinations.
+// A downstream outbuff that turns "bad" is skipped from then on, and this
+// object turns "bad" when all of them are.
+template <typename CharT, std::size_t N>
+class basic_tee_writer final: public strf::basic_outbuff<CharT>
+{
+    static_assert(N != 0, "basic_tee_writer requires at least one destination");
+
+public:
+
+    static constexpr std::size_t buffer_size = 512 / sizeof(CharT);
+
+    explicit basic_tee_writer(const std::array<strf::basic_outbuff<CharT>*, N>& dests)
+        : strf::basic_outbuff<CharT>(buf_, buf_ + buffer_size)
+        , dests_(dests)
+    {
+    }
+
+    template < typename ... OB
+             , std::enable_if_t
+                 < sizeof...(OB) == N
+                && strf::detail::fold_and
+                     < std::is_convertible<OB*, strf::basic_outbuff<CharT>*>::value... >
+                 , int > = 0 >
+    explicit basic_tee_writer(OB& ... dests)
+        : strf::basic_outbuff<CharT>(buf_, buf_ + buffer_size)
+        , dests_{{ &dests... }}
+    {
+    }
+
+    basic_tee_writer(const basic_tee_writer&) = delete;
+    basic_tee_writer(basic_tee_writer&&) = delete;
+
+    void recycle() override
+    {
+        if (this->good()) {
+            auto len = this->pointer() - buf_;
+            this->set_pointer(buf_);
+            this->set_good(false);
+            this->set_good(flush_(len));
+        }
+        if ( ! this->good()) {
+            this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+            this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+        }
+    }
+
+    void finish()
+    {
+        if (this->good()) {
+            auto len = this->pointer() - buf_;
+            this->set_good(false);
+            flush_(len);
+        }
+        this->set_pointer(strf::outbuff_garbage_buf<CharT>());
+        this->set_end(strf::outbuff_garbage_buf_end<CharT>());
+    }
+
+private:
+
+    bool flush_(std::ptrdiff_t len)
+    {
+        bool any_good = false;
+        for (auto* dest : dests_) {
+            if (dest->good()) {
+                strf::write(*dest, buf_, len);
+                any_good = any_good || dest->good();
+            }
+        }
+        return any_good;
+    }
+
+    std::array<strf::basic_outbuff<CharT>*, N> dests_;
+    CharT buf_[buffer_size];
+};
+
+template <std::size_t N>
+using tee_writer = basic_tee_writer<char, N>;
+
+template <std::size_t N>
+using u16tee_writer = basic_tee_writer<char16_t, N>;
+
+template <std::size_t N>
+using u32tee_writer = basic_tee_writer<char32_t, N>;
+
+template <std::size_t N>
+using wtee_writer = basic_tee_writer<wchar_t, N>;
+
+namespace detail {
+
+template <typename CharT, std::size_t N>
+class basic_tee_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuff_type = strf::basic_tee_writer<CharT, N>;
+
+    template < typename ... OB
+             , std::enable_if_t
+                 < strf::detail::fold_and
+                     < std::is_convertible<OB*, strf::basic_outbuff<CharT>*>::value... >
+                 , int > = 0 >
+    explicit basic_tee_writer_creator(OB& ... obs) noexcept
+        : dests_{{ &obs... }}
+    {
+    }
+
+    const std::array<strf::basic_outbuff<CharT>*, N>& create() const noexcept
+    {
+        return dests_;
+    }
+
+private:
+
+    std::array<strf::basic_outbuff<CharT>*, N> dests_;
+};
+
+} // namespace detail
+
+template <typename CharT, typename ... OB>
+inline auto to_tee(strf::basic_outbuff<CharT>& ob, OB& ... obs)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_tee_writer_creator<CharT, 1 + sizeof...(OB)> >
+        (ob, obs...);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_TEE_HPP
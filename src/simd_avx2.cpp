@@ -0,0 +1,23 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// The SIMD kernels compiled for AVX2, which
+// strf::detail::simd::dispatched_kernels() selects at run time.
+
+#if ! defined(__AVX2__)
+#  error "This file must be compiled with AVX2 enabled"
+#endif
+
+#define STRF_SIMD_TARGET avx2
+#include <strf/detail/simd.hpp>
+
+namespace strf {
+namespace detail {
+namespace simd {
+
+extern const kernels_table avx2_kernels = strf::detail::simd::avx2::target_kernels();
+
+} // namespace simd
+} // namespace detail
+} // namespace strf
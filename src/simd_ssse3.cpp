@@ -0,0 +1,23 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// The SIMD kernels compiled for SSSE3, which
+// strf::detail::simd::dispatched_kernels() selects at run time.
+
+#if ! defined(__SSSE3__)
+#  error "This file must be compiled with SSSE3 enabled"
+#endif
+
+#define STRF_SIMD_TARGET ssse3
+#include <strf/detail/simd.hpp>
+
+namespace strf {
+namespace detail {
+namespace simd {
+
+extern const kernels_table ssse3_kernels = strf::detail::simd::ssse3::target_kernels();
+
+} // namespace simd
+} // namespace detail
+} // namespace strf
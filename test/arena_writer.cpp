@@ -0,0 +1,129 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_arena.hpp>
+#include "test_utils.hpp"
+#include <thread>
+
+template <typename CharT>
+static std::basic_string<CharT> to_std_string(const typename strf::basic_arena_writer<CharT>::result& r)
+{
+    return {r.data(), r.size()};
+}
+
+template <typename CharT>
+static void test_successfull_writing()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    std::basic_string<CharT> expected;
+
+    strf::arena arena(256);
+    strf::basic_arena_writer<CharT> writer(arena);
+    for (int i = 0; i < 10; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+        expected.append(double_str.begin(), double_str.size());
+    }
+    auto result = writer.finish();
+
+    TEST_EQ(result.size(), expected.size());
+    TEST_TRUE(to_std_string<CharT>(result) == expected);
+}
+
+template <typename CharT>
+static void test_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto full_str = test_utils::make_full_string<CharT>();
+    std::basic_string<CharT> expected(half_str.begin(), half_str.size());
+    expected.append(full_str.begin(), full_str.size());
+
+    strf::arena arena;
+    {
+        auto result = strf::to_arena<CharT>(arena) (half_str, full_str);
+        TEST_TRUE(to_std_string<CharT>(result) == expected);
+    }
+    {
+        auto result = strf::to_arena<CharT>(arena).reserve_calc() (half_str, full_str);
+        TEST_TRUE(to_std_string<CharT>(result) == expected);
+    }
+}
+
+static void test_results_remain_valid()
+{
+    strf::arena arena(128);
+    auto r1 = strf::to_arena(arena) ("Hello ", 1);
+    auto r2 = strf::to_arena(arena) ("Hello ", 2);
+    auto big = strf::to_arena(arena) (strf::right("x", 1000, '.'));
+    auto p = static_cast<int*>(arena.allocate(sizeof(int), alignof(int)));
+    *p = 123;
+    auto r3 = strf::to_arena<char16_t>(arena) (u"Hello ", 3);
+
+    TEST_TRUE(to_std_string<char>(r1) == "Hello 1");
+    TEST_TRUE(to_std_string<char>(r2) == "Hello 2");
+    TEST_TRUE(to_std_string<char>(big) == std::string(999, '.') + "x");
+    TEST_TRUE(to_std_string<char16_t>(r3) == u"Hello 3");
+    TEST_EQ(*p, 123);
+
+    // consecutive results are contiguous in the arena
+    TEST_TRUE(r1.data() + r1.size() == r2.data());
+
+    arena.reset();
+    auto r4 = strf::to_arena(arena) ("abc");
+    TEST_TRUE(to_std_string<char>(r4) == "abc");
+}
+
+template <typename CharT>
+static void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    strf::arena arena;
+    strf::basic_arena_writer<CharT> writer(arena);
+    write(writer, half_str.begin(), half_str.size());
+    test_utils::turn_into_bad(writer);
+    writer.recycle();
+    write(writer, double_str.begin(), double_str.size());
+    auto result = writer.finish();
+
+    TEST_TRUE(to_std_string<CharT>(result) == std::basic_string<CharT>(half_str.begin(), half_str.size()));
+}
+
+static void test_finish_in_another_thread()
+{
+    // The writer must know that it is no longer writing into the arena
+    // even after the thread where it turned bad, and its garbage buffer,
+    // are gone
+    auto half_str = test_utils::make_half_string<char>();
+    auto double_str = test_utils::make_double_string<char>();
+
+    strf::arena arena;
+    strf::arena_writer writer(arena);
+    std::thread t{ [&]() {
+        write(writer, half_str.begin(), half_str.size());
+        test_utils::turn_into_bad(writer);
+        writer.recycle();
+        write(writer, double_str.begin(), double_str.size());
+    } };
+    t.join();
+    auto result = writer.finish();
+
+    TEST_TRUE(to_std_string<char>(result) == std::string(half_str.begin(), half_str.size()));
+}
+
+void test_arena_writer()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+
+    test_destination<char>();
+    test_destination<wchar_t>();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char16_t>();
+    test_finish_in_another_thread();
+
+    test_results_remain_valid();
+}
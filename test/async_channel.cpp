@@ -0,0 +1,167 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_async_channel.hpp>
+#include "test_utils.hpp"
+
+#if defined(STRF_HAS_COROUTINES)
+
+#include <strf/to_string.hpp>
+#include <algorithm>
+
+namespace {
+
+struct test_task
+{
+    struct promise_type
+    {
+        test_task get_return_object()
+        {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    test_task(std::coroutine_handle<promise_type> h)
+        : handle(h)
+    {
+    }
+    test_task(const test_task&) = delete;
+    ~test_task()
+    {
+        handle.destroy();
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Stands for a socket: reads at most chunk_size characters at a time
+test_task consumer
+    ( strf::async_channel& ch
+    , std::size_t chunk_size
+    , std::string& output
+    , std::size_t& max_pending )
+{
+    for(;;) {
+        co_await ch.wait_for_data();
+        if (ch.size() == 0 && ch.closed()) {
+            break;
+        }
+        max_pending = std::max(max_pending, ch.size());
+        auto n = std::min(ch.size(), chunk_size);
+        output.append(ch.data(), n);
+        ch.consume(n);
+    }
+}
+
+test_task producer(strf::async_channel& ch, int lines)
+{
+    for (int i = 0; i < lines; ++i) {
+        co_await strf::async_to(ch) ("line ", i, ": ", strf::right(i, 10, '*'), '\n');
+    }
+    co_await strf::async_to(ch).with(strf::numpunct<10>(3)) (1000000, '\n');
+    ch.close();
+}
+
+test_task producer_of_large_argument(strf::async_channel& ch, const std::string& big)
+{
+    co_await strf::async_to(ch) ("<", big, ">");
+    ch.close();
+}
+
+std::string expected_lines(int lines)
+{
+    std::string expected;
+    for (int i = 0; i < lines; ++i) {
+        expected += strf::to_string("line ", i, ": ", strf::right(i, 10, '*'), '\n');
+    }
+    expected += "1,000,000\n";
+    return expected;
+}
+
+} // unnamed namespace
+
+static void test_backpressure()
+{
+    strf::async_channel ch(64);
+    std::string output;
+    std::size_t max_pending = 0;
+    auto p = producer(ch, 200);
+    auto c = consumer(ch, 10, output, max_pending);
+
+    p.handle.resume(); // runs until the channel is full
+    TEST_TRUE(! p.handle.done());
+    TEST_TRUE(ch.size() != 0);
+    TEST_TRUE(ch.size() <= 64);
+
+    c.handle.resume(); // from now on, both are resumed by each other
+    TEST_TRUE(p.handle.done());
+    TEST_TRUE(c.handle.done());
+    TEST_TRUE(output == expected_lines(200));
+    TEST_TRUE(max_pending <= 64);
+}
+
+static void test_consumer_first()
+{
+    strf::async_channel ch(64);
+    std::string output;
+    std::size_t max_pending = 0;
+    auto p = producer(ch, 50);
+    auto c = consumer(ch, 1000, output, max_pending);
+
+    c.handle.resume(); // waits for data
+    TEST_TRUE(! c.handle.done());
+    p.handle.resume();
+    TEST_TRUE(p.handle.done());
+    TEST_TRUE(c.handle.done());
+    TEST_TRUE(output == expected_lines(50));
+}
+
+static void test_argument_larger_than_capacity()
+{
+    const std::string big(1000, 'x');
+    strf::async_channel ch(64);
+    std::string output;
+    std::size_t max_pending = 0;
+    auto p = producer_of_large_argument(ch, big);
+    auto c = consumer(ch, 7, output, max_pending);
+
+    p.handle.resume();
+    c.handle.resume();
+    TEST_TRUE(p.handle.done());
+    TEST_TRUE(c.handle.done());
+    TEST_TRUE(output == "<" + big + ">");
+}
+
+static void test_synchronous_use()
+{
+    // the channel is also a regular outbuff
+    strf::async_channel ch(64);
+    strf::to(ch) ("abc", strf::right("", 100, '.'), "def");
+    TEST_EQ(ch.size(), 106);
+    TEST_TRUE(std::string(ch.data(), ch.size()) == "abc" + std::string(100, '.') + "def");
+    ch.consume(3);
+    TEST_EQ(ch.size(), 103);
+    ch.consume(103);
+    TEST_EQ(ch.size(), 0);
+}
+
+void test_async_channel()
+{
+    test_backpressure();
+    test_consumer_first();
+    test_argument_larger_than_capacity();
+    test_synchronous_use();
+}
+
+#else // defined(STRF_HAS_COROUTINES)
+
+void test_async_channel()
+{
+}
+
+#endif // defined(STRF_HAS_COROUTINES)
@@ -0,0 +1,124 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <strf/to_async_fd.hpp>
+#include "test_utils.hpp"
+
+template <typename CharT>
+static void test_successfull_writing(std::size_t buffers_count)
+{
+    // many recycles through small buffers
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_async_fd_writer<CharT> writer
+        ( fileno(file), test_utils::full_string_size<CharT>, buffers_count );
+    for (int i = 0; i < 100; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+    }
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, 100 * double_str.size());
+    for (std::size_t i = 0; i < 100; ++i) {
+        TEST_TRUE(0 == obtained_content.compare( i * double_str.size()
+                                               , double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+    }
+}
+
+template <typename CharT>
+static void test_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto full_str = test_utils::make_full_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    auto status = strf::to_async_fd<CharT>(fileno(file)) (half_str, full_str);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, half_str.size() + full_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                           , half_str.begin()
+                                           , half_str.size() ));
+    TEST_TRUE(0 == obtained_content.compare( half_str.size()
+                                           , full_str.size()
+                                           , full_str.begin()
+                                           , full_str.size() ));
+}
+
+template <typename CharT>
+static void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_async_fd_writer<CharT> writer(fileno(file));
+
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.begin(), double_str.size());
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, half_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                           , half_str.begin()
+                                           , half_str.size() ));
+}
+
+static void test_invalid_fd()
+{
+    {
+        auto status = strf::to_async_fd(-1) ("Hello World");
+        TEST_TRUE(! status.success);
+        TEST_EQ(status.count, 0);
+    }
+    {
+        // the failure is noticed in a later recycle
+        strf::async_fd_writer writer(-1, 100);
+        for (int i = 0; i < 100; ++i) {
+            strf::to(writer) ("Hello World");
+        }
+        TEST_TRUE(! writer.good());
+        auto status = writer.finish();
+        TEST_TRUE(! status.success);
+        TEST_EQ(status.count, 0);
+    }
+}
+
+void test_async_fd_writer()
+{
+    test_destination<char>();
+    test_destination<char16_t>();
+    test_destination<wchar_t>();
+
+    test_successfull_writing<char>(2);
+    test_successfull_writing<char>(4);
+    test_successfull_writing<char16_t>(2);
+    test_successfull_writing<char32_t>(3);
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char16_t>();
+
+    test_invalid_fd();
+}
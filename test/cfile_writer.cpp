@@ -205,6 +205,55 @@ void test_destination()
 
 }
 
+template <typename CharT>
+void test_destination_with_buffer()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    CharT buff[test_utils::full_string_size<CharT>];
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+
+    auto status = strf::to(file, buff)(double_str, double_str);
+    std::fclose(file);
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, 2 * double_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+    TEST_TRUE(0 == obtained_content.compare( double_str.size()
+                                           , double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+}
+
+void test_wdestination_with_buffer()
+{
+    auto double_str = test_utils::make_double_string<wchar_t>();
+    wchar_t buff[test_utils::full_string_size<wchar_t>];
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+
+    auto status = strf::wto(file, buff, test_utils::full_string_size<wchar_t>)
+        (double_str, double_str);
+    std::fclose(file);
+    auto obtained_content = test_utils::read_wfile(path.c_str());
+    std::remove(path.c_str());
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, 2 * double_str.size());
+    TEST_TRUE(0 == obtained_content.compare( double_str.size()
+                                           , double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+}
+
 void test_wdestination()
 {
     auto half_str = test_utils::make_half_string<wchar_t>();
@@ -242,6 +291,13 @@ void test_cfile_writer()
 
     test_wdestination();
 
+    test_destination_with_buffer<char>();
+    test_destination_with_buffer<char16_t>();
+    test_destination_with_buffer<char32_t>();
+    test_destination_with_buffer<wchar_t>();
+
+    test_wdestination_with_buffer();
+
     test_narrow_successfull_writing<char>();
     test_narrow_successfull_writing<char16_t>();
     test_narrow_successfull_writing<char32_t>();
@@ -0,0 +1,106 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_chunks.hpp>
+#include "test_utils.hpp"
+
+template <typename CharT>
+static void test_successfull_writing()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    std::basic_string<CharT> expected;
+
+    strf::basic_chunk_pool<CharT> pool(100);
+    strf::basic_chunks_writer<CharT> writer(pool);
+    for (int i = 0; i < 10; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+        expected.append(double_str.begin(), double_str.size());
+    }
+    auto chunks = writer.finish();
+
+    TEST_EQ(chunks.size(), expected.size());
+    TEST_TRUE(chunks.to_string() == expected);
+    for (const auto& s: chunks.segments()) {
+        TEST_TRUE(s.size <= 100);
+    }
+
+    std::basic_string<CharT> copy(chunks.size(), CharT('x'));
+    auto end = chunks.copy_to(&copy[0]);
+    TEST_TRUE(end == &copy[0] + copy.size());
+    TEST_TRUE(copy == expected);
+}
+
+static void test_chunks_are_reused()
+{
+    strf::chunk_pool pool(64);
+    const char* first_chunk = nullptr;
+    {
+        auto chunks = strf::to_chunks(pool) ("Hello World");
+        TEST_EQ(chunks.segments().size(), 1);
+        first_chunk = chunks.segments()[0].data;
+        TEST_TRUE(chunks.to_string() == "Hello World");
+    }
+    auto chunks = strf::to_chunks(pool) ("Hello", ' ', "World");
+    TEST_EQ(chunks.segments().size(), 1);
+    TEST_TRUE(chunks.segments()[0].data == first_chunk);
+    TEST_TRUE(chunks.to_string() == "Hello World");
+}
+
+static void test_empty_output()
+{
+    strf::chunk_pool pool;
+    auto chunks = strf::to_chunks(pool) ("");
+    TEST_EQ(chunks.size(), 0);
+    TEST_EQ(chunks.segments().size(), 0);
+    TEST_TRUE(chunks.to_string().empty());
+}
+
+template <typename CharT>
+static void test_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto full_str = test_utils::make_full_string<CharT>();
+    std::basic_string<CharT> expected(half_str.begin(), half_str.size());
+    expected.append(full_str.begin(), full_str.size());
+
+    strf::basic_chunk_pool<CharT> pool(80);
+    auto chunks = strf::to_chunks(pool) (half_str, full_str);
+
+    TEST_EQ(chunks.size(), expected.size());
+    TEST_TRUE(chunks.to_string() == expected);
+}
+
+template <typename CharT>
+static void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    strf::basic_chunk_pool<CharT> pool;
+    strf::basic_chunks_writer<CharT> writer(pool);
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.begin(), double_str.size());
+    auto chunks = writer.finish();
+
+    TEST_EQ(chunks.size(), half_str.size());
+    TEST_TRUE(chunks.to_string() == std::basic_string<CharT>(half_str.begin(), half_str.size()));
+}
+
+void test_chunks_writer()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+
+    test_destination<char>();
+    test_destination<wchar_t>();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char16_t>();
+
+    test_chunks_are_reused();
+    test_empty_output();
+}
@@ -124,6 +124,102 @@ void STRF_TEST_FUNC test_destinations()
 }
 
 
+static void STRF_TEST_FUNC test_cstr_counting_writer()
+{
+    {   // not truncated
+        char buff[12];
+        strf::cstr_counting_writer w(buff);
+        write(w, "Hello");
+        write(w, " World");
+        auto r = w.finish();
+
+        TEST_TRUE(! r.truncated);
+        TEST_EQ(r.required_size, 11);
+        TEST_EQ(r.ptr, &buff[11]);
+        TEST_CSTR_EQ(buff, "Hello World");
+    }
+    {   // truncated, with many recycles after that
+        char buff[8];
+        strf::cstr_counting_writer w(buff);
+        write(w, "Hello");
+        write(w, " World");
+        for (int i = 0; i < 100; ++i) {
+            write(w, "blah blah blah");
+            w.recycle();
+        }
+        TEST_TRUE(w.good());
+        auto r = w.finish();
+
+        TEST_TRUE(r.truncated);
+        TEST_EQ(r.required_size, 11 + 100 * 14);
+        TEST_EQ(r.ptr, &buff[7]);
+        TEST_CSTR_EQ(buff, "Hello W");
+        TEST_TRUE(! w.good());
+    }
+    {   // turned into bad
+        char buff[8];
+        strf::cstr_counting_writer w(buff);
+        write(w, "abc");
+        test_utils::turn_into_bad(w);
+        auto r = w.finish();
+
+        TEST_TRUE(r.truncated);
+        TEST_EQ(r.required_size, 3);
+        TEST_CSTR_EQ(buff, "abc");
+    }
+}
+
+template <typename CharT>
+void STRF_TEST_FUNC test_counting_destinations()
+{
+    const auto half_str = test_utils::make_half_string<CharT>();
+    const auto full_str = test_utils::make_full_string<CharT>();
+    constexpr std::size_t required_size
+        = test_utils::full_string_size<CharT>
+        + test_utils::half_string_size<CharT>;
+    {
+        CharT buff[test_utils::half_string_size<CharT>];
+        auto res = strf::to_counting(buff) (full_str,  half_str);
+
+        TEST_TRUE(res.truncated);
+        TEST_EQ(res.required_size, required_size);
+        TEST_TRUE(res.ptr == buff + test_utils::half_string_size<CharT> - 1);
+        TEST_TRUE(*res.ptr == CharT());
+    }
+    {
+        // retrying with the reported size is enough
+        CharT small_buff[10];
+        auto res = strf::to_counting(small_buff, 10) (full_str,  half_str);
+        TEST_TRUE(res.truncated);
+        TEST_EQ(res.required_size, required_size);
+
+        CharT buff[required_size + 1];
+        res = strf::to_counting(buff, buff + res.required_size + 1) (full_str,  half_str);
+
+        TEST_TRUE(! res.truncated);
+        TEST_EQ(res.required_size, required_size);
+        TEST_TRUE(res.ptr == buff + required_size);
+        TEST_TRUE(strf::detail::str_equal( full_str.begin()
+                                         , buff
+                                         , test_utils::full_string_size<CharT>) );
+        TEST_TRUE(strf::detail::str_equal( half_str.begin()
+                                         , buff + test_utils::full_string_size<CharT>
+                                         , test_utils::half_string_size<CharT>) );
+    }
+}
+
+static void STRF_TEST_FUNC test_counting_with_transcoding()
+{
+    // the transcoders stop writing when good() is false
+    const char* u8str = "abc\xC4\x80\xF0\x90\x80\x80xyz";  // 2 + 1 UTF-16 surrogates
+    char16_t buff[4];
+    auto res = strf::to_counting(buff) (strf::conv(u8str), strf::right(1, 10, '.'));
+    TEST_TRUE(res.truncated);
+    TEST_EQ(res.required_size, 19);
+    TEST_TRUE(buff[0] == u'a' && buff[1] == u'b' && buff[2] == u'c' && buff[3] == 0);
+}
+
+
 void STRF_TEST_FUNC test_cstr_writer()
 {
     test_cstr_writer_destination_too_small();
@@ -133,4 +229,11 @@ void STRF_TEST_FUNC test_cstr_writer()
     test_destinations<char16_t>();
     test_destinations<char32_t>();
     test_destinations<wchar_t>();
+
+    test_cstr_counting_writer();
+    test_counting_destinations<char>();
+    test_counting_destinations<char16_t>();
+    test_counting_destinations<char32_t>();
+    test_counting_destinations<wchar_t>();
+    test_counting_with_transcoding();
 }
@@ -0,0 +1,165 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <strf/to_fd.hpp>
+#include "test_utils.hpp"
+
+template <typename CharT>
+static void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_fd_writer<CharT> writer(fileno(file));
+
+    write(writer, tiny_str.begin(), tiny_str.size());
+    write(writer, double_str.begin(), double_str.size());
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, tiny_str.size() + double_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, tiny_str.size()
+                                           , tiny_str.begin()
+                                           , tiny_str.size() ));
+    TEST_TRUE(0 == obtained_content.compare( tiny_str.size()
+                                           , double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+}
+
+template <typename CharT>
+static void test_external_buffer()
+{
+    // many recycles through a small, caller provided buffer
+    auto double_str = test_utils::make_double_string<CharT>();
+    CharT buff[test_utils::full_string_size<CharT>];
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_fd_writer<CharT> writer(fileno(file), buff, sizeof(buff) / sizeof(buff[0]));
+    for (int i = 0; i < 10; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+    }
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, 10 * double_str.size());
+    for (std::size_t i = 0; i < 10; ++i) {
+        TEST_TRUE(0 == obtained_content.compare( i * double_str.size()
+                                               , double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+    }
+}
+
+template <typename CharT>
+static void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_fd_writer<CharT> writer(fileno(file));
+
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.begin(), double_str.size());
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, half_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                           , half_str.begin()
+                                           , half_str.size() ));
+}
+
+template <typename CharT>
+static void test_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto full_str = test_utils::make_full_string<CharT>();
+    {
+        std::FILE* file = std::tmpfile();
+        auto status = strf::to_fd<CharT>(fileno(file)) (half_str, full_str);
+        std::rewind(file);
+        auto obtained_content = test_utils::read_file<CharT>(file);
+        std::fclose(file);
+
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, obtained_content.size());
+        TEST_EQ(status.count, half_str.size() + full_str.size());
+        TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                               , half_str.begin()
+                                               , half_str.size() ));
+        TEST_TRUE(0 == obtained_content.compare( half_str.size()
+                                               , full_str.size()
+                                               , full_str.begin()
+                                               , full_str.size() ));
+    }
+    {
+        CharT buff[test_utils::full_string_size<CharT>];
+        std::FILE* file = std::tmpfile();
+        auto status = strf::to_fd(fileno(file), buff) (half_str, full_str);
+        std::rewind(file);
+        auto obtained_content = test_utils::read_file<CharT>(file);
+        std::fclose(file);
+
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, obtained_content.size());
+        TEST_EQ(status.count, half_str.size() + full_str.size());
+        TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                               , half_str.begin()
+                                               , half_str.size() ));
+        TEST_TRUE(0 == obtained_content.compare( half_str.size()
+                                               , full_str.size()
+                                               , full_str.begin()
+                                               , full_str.size() ));
+    }
+}
+
+static void test_invalid_fd()
+{
+    auto status = strf::to_fd(-1) ("Hello World");
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, 0);
+}
+
+void test_fd_writer()
+{
+    test_destination<char>();
+    test_destination<char16_t>();
+    test_destination<char32_t>();
+    test_destination<wchar_t>();
+
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+
+    test_external_buffer<char>();
+    test_external_buffer<char16_t>();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char16_t>();
+    test_failing_to_recycle<char32_t>();
+    test_failing_to_recycle<wchar_t>();
+
+    test_invalid_fd();
+}
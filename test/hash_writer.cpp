@@ -0,0 +1,131 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_hash.hpp>
+#include <strf/to_string.hpp>
+#include "test_utils.hpp"
+
+template <typename Hasher>
+static typename Hasher::result_type hash_of(const std::string& str, std::size_t chunk_size)
+{
+    Hasher h;
+    for (std::size_t i = 0; i < str.size(); i += chunk_size) {
+        auto n = str.size() - i < chunk_size ? str.size() - i : chunk_size;
+        h.update(str.data() + i, n);
+    }
+    return h.digest();
+}
+
+static void test_fnv1a_64()
+{
+    TEST_TRUE(strf::fnv1a_64{}.digest() == 0xcbf29ce484222325ull);
+    TEST_TRUE(hash_of<strf::fnv1a_64>("a", 1) == 0xaf63dc4c8601ec8cull);
+    TEST_TRUE(hash_of<strf::fnv1a_64>("foobar", 1) == 0x85944171f73967e8ull);
+    TEST_TRUE(hash_of<strf::fnv1a_64>("foobar", 4) == 0x85944171f73967e8ull);
+}
+
+static void test_xxhash64()
+{
+    TEST_TRUE(strf::xxhash64{}.digest() == 0xef46db3751d8e999ull);
+    TEST_TRUE(hash_of<strf::xxhash64>("a", 1) == 0xd24ec4f1a98c6e5bull);
+    TEST_TRUE(hash_of<strf::xxhash64>("abc", 1) == 0x44bc2cf5ad770999ull);
+    TEST_TRUE(hash_of<strf::xxhash64>("Nobody inspects the spammish repetition", 100)
+              == 0xfbcea83c8a378bf1ull);
+
+    // The result must not depend on how the input is split
+    std::string str;
+    for (int i = 0; i < 100; ++i) {
+        str += strf::to_string("abcdefghij", i);
+    }
+    auto expected = hash_of<strf::xxhash64>(str, str.size());
+    TEST_TRUE(hash_of<strf::xxhash64>(str, 1) == expected);
+    TEST_TRUE(hash_of<strf::xxhash64>(str, 7) == expected);
+    TEST_TRUE(hash_of<strf::xxhash64>(str, 32) == expected);
+    TEST_TRUE(hash_of<strf::xxhash64>(str, 33) == expected);
+    TEST_TRUE(hash_of<strf::xxhash64>(str, 500) == expected);
+}
+
+namespace {
+
+// user-supplied hasher
+struct content_recorder
+{
+    using result_type = std::string;
+
+    void update(const void* data, std::size_t size)
+    {
+        ++calls;
+        content.append(static_cast<const char*>(data), size);
+    }
+    std::string digest() const
+    {
+        return strf::to_string(calls > 1 ? "many calls:" : "one call:", content);
+    }
+
+    std::string content;
+    int calls = 0;
+};
+
+} // unnamed namespace
+
+static void test_destination()
+{
+    {
+        auto h = strf::to_hash() ("foo", "bar");
+        TEST_TRUE(h == 0x85944171f73967e8ull);
+    }
+    {
+        auto h = strf::to_hash<strf::xxhash64>() ("abc");
+        TEST_TRUE(h == 0x44bc2cf5ad770999ull);
+    }
+    {
+        auto h = strf::to_hash<strf::xxhash64>() ("Nobody inspects", " the spammish ", "repetition");
+        TEST_TRUE(h == 0xfbcea83c8a378bf1ull);
+    }
+    {
+        // content larger than the internal buffer
+        auto h = strf::to_hash(strf::xxhash64(123))
+            ( strf::right(0, 1000, '.'), strf::join_left(2000, '*')(1, 2, 3) );
+        auto str = strf::to_string
+            ( strf::right(0, 1000, '.'), strf::join_left(2000, '*')(1, 2, 3) );
+        strf::xxhash64 hasher(123);
+        hasher.update(str.data(), str.size());
+        TEST_TRUE(h == hasher.digest());
+    }
+    {
+        auto result = strf::to_hash<content_recorder>() ("abc", 123);
+        TEST_TRUE(result == "one call:abc123");
+
+        result = strf::to_hash(content_recorder{}).tr("{}-{}", strf::right("", 1000, '.'), 1);
+        TEST_TRUE(result == "many calls:" + std::string(1000, '.') + "-1");
+    }
+    {
+        // char16_t: the hashed bytes are the code units in memory
+        auto h = strf::to_hash<strf::fnv1a_64, char16_t>() (u"abc", 123);
+        std::u16string str = u"abc123";
+        strf::fnv1a_64 hasher;
+        hasher.update(str.data(), str.size() * sizeof(char16_t));
+        TEST_TRUE(h == hasher.digest());
+    }
+}
+
+static void test_failing_to_recycle()
+{
+    strf::basic_hash_writer<char, content_recorder> writer;
+    strf::to(writer) ("abc", strf::right("", 1000, '.'));
+    test_utils::turn_into_bad(writer);
+    writer.recycle();
+    strf::to(writer) ("def");
+    auto result = writer.finish();
+    TEST_TRUE(result.size() < 11 + 1003); // the content in the buffer was discarded
+    TEST_TRUE(result.find("def") == std::string::npos);
+}
+
+void test_hash_writer()
+{
+    test_fnv1a_64();
+    test_xxhash64();
+    test_destination();
+    test_failing_to_recycle();
+}
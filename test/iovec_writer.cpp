@@ -0,0 +1,104 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+#include <strf/to_iovec.hpp>
+
+static std::string join_segments(const std::vector<::iovec>& segments)
+{
+    std::string str;
+    for (const auto& v: segments) {
+        str.append(static_cast<const char*>(v.iov_base), v.iov_len);
+    }
+    return str;
+}
+
+static void test_iovec_borrowing()
+{
+    const std::string big(1000, 'x');
+    const std::string big2(300, 'y');
+
+    auto res = strf::to_iovec() ("abc", big, 123, big2, strf::right("def", 5));
+
+    const std::string expected = "abc" + big + "123" + big2 + "  def";
+    TEST_EQ(res.count, expected.size());
+    TEST_TRUE(join_segments(res.segments) == expected);
+
+    // the large strings are referenced, not copied
+    TEST_EQ(res.segments.size(), 5);
+    TEST_TRUE(res.segments[1].iov_base == static_cast<const void*>(big.data()));
+    TEST_TRUE(res.segments[3].iov_base == static_cast<const void*>(big2.data()));
+}
+
+static void test_iovec_without_borrowing()
+{
+    const std::string big(1000, 'x');
+
+    // threshold above the string size: everything is copied
+    auto res = strf::to_iovec(100, 2000) ("abc", big, 123);
+
+    const std::string expected = "abc" + big + "123";
+    TEST_EQ(res.count, expected.size());
+    TEST_TRUE(join_segments(res.segments) == expected);
+    for (const auto& v: res.segments) {
+        TEST_TRUE(v.iov_base != static_cast<const void*>(big.data()));
+        TEST_TRUE(v.iov_len <= 100);
+    }
+}
+
+static void test_can_borrow()
+{
+    strf::iovec_writer iov;
+    strf::writev_writer wv(-1);
+    strf::discarded_outbuff<char> discarded;
+    TEST_TRUE(iov.can_borrow());
+    TEST_TRUE(wv.can_borrow());
+    TEST_TRUE(! discarded.can_borrow());
+    iov.finish();
+    wv.finish();
+}
+
+static void test_writev()
+{
+    const std::string big(1000, 'x');
+    std::string expected;
+    std::FILE* file = std::tmpfile();
+    {
+        strf::writev_writer ob(fileno(file), 128);
+        for (int i = 0; i < 100; ++i) {
+            strf::to(ob) (i, ':', big, '\n');
+            expected += std::to_string(i) + ':' + big + '\n';
+        }
+        auto res = ob.finish();
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, expected.size());
+    }
+    {
+        auto res = strf::to_fd_writev(fileno(file)) ("--", big, "--");
+        expected += "--" + big + "--";
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, big.size() + 4);
+    }
+    std::rewind(file);
+    auto obtained = test_utils::read_file<char>(file);
+    std::fclose(file);
+    TEST_TRUE(obtained == expected);
+}
+
+static void test_writev_invalid_fd()
+{
+    const std::string big(1000, 'x');
+    auto res = strf::to_fd_writev(-1) ("abc", big);
+    TEST_TRUE(! res.success);
+    TEST_EQ(res.count, 0);
+}
+
+void test_iovec_writer()
+{
+    test_iovec_borrowing();
+    test_iovec_without_borrowing();
+    test_can_borrow();
+    test_writev();
+    test_writev_invalid_fd();
+}
@@ -51,19 +51,62 @@ void test_single_byte_encodings();
 void test_cstr_writer();
 void test_locale();
 void test_cfile_writer();
+void test_chunks_writer();
+void test_arena_writer();
+void test_scratch_writer();
+void test_async_channel();
+void test_hash_writer();
+void test_tee_writer();
 void test_printable_overriding();
 void test_streambuf_writer();
 void test_string_writer();
+void test_measure();
+void test_records();
+#if ! defined(_WIN32)
+void test_fd_writer();
+void test_iovec_writer();
+void test_mapped_file_writer();
+void test_ring_writer();
+void test_async_fd_writer();
+#endif
 
 int main() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // The tests built with -mavx2 or -mssse3 are skipped
+    // ( exit code 77 ) on a CPU that does not support it
+#  if defined(__AVX2__)
+    if ( ! __builtin_cpu_supports("avx2")) {
+        return 77;
+    }
+#  elif defined(__SSSE3__)
+    if ( ! __builtin_cpu_supports("ssse3")) {
+        return 77;
+    }
+#  endif
+#endif
     strf::narrow_cfile_writer<char> test_outbuff(stdout);
     test_utils::set_test_outbuff(test_outbuff);
 
     test_cstr_writer();
     test_locale();
     test_cfile_writer();
+    test_chunks_writer();
+    test_arena_writer();
+    test_scratch_writer();
+    test_async_channel();
+    test_hash_writer();
+    test_tee_writer();
     test_streambuf_writer();
     test_string_writer();
+    test_measure();
+    test_records();
+#if ! defined(_WIN32)
+    test_fd_writer();
+    test_iovec_writer();
+    test_mapped_file_writer();
+    test_ring_writer();
+    test_async_fd_writer();
+#endif
 
     test_dynamic_charset();
     test_encode_char();
@@ -0,0 +1,206 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+#include <strf/to_mapped_file.hpp>
+#include <sys/stat.h>
+
+template <typename CharT>
+static void test_successfull_writing()
+{
+    // initial size is small, so that the mapping is enlarged many times
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_mapped_file_writer<CharT> writer(fileno(file), 100);
+    for (int i = 0; i < 10; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+    }
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, 10 * double_str.size());
+    for (std::size_t i = 0; i < 10; ++i) {
+        TEST_TRUE(0 == obtained_content.compare( i * double_str.size()
+                                               , double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+    }
+}
+
+template <typename CharT>
+static void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_mapped_file_writer<CharT> writer(fileno(file), 100);
+
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.begin(), double_str.size());
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, half_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                           , half_str.begin()
+                                           , half_str.size() ));
+}
+
+template <typename CharT>
+static void test_writing_a_lot_after_turning_bad()
+{
+    // After turning bad, the writer must not see the rest of the
+    // mapping as free space, since it then writes into the garbage buffer
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    strf::basic_mapped_file_writer<CharT> writer(fileno(file), 1000);
+
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle();
+    test_utils::turn_into_bad(writer);
+    writer.recycle();
+    TEST_EQ(writer.space(), strf::min_space_after_recycle<CharT>());
+    for (int i = 0; i < 20; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+        TEST_TRUE(writer.space() <= strf::min_space_after_recycle<CharT>());
+    }
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, half_str.size());
+    TEST_EQ(obtained_content.size(), half_str.size());
+}
+
+template <typename CharT>
+static void test_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto full_str = test_utils::make_full_string<CharT>();
+    {
+        std::FILE* file = std::tmpfile();
+        auto status = strf::to_mapped_file<CharT>(fileno(file)) (half_str, full_str);
+        std::rewind(file);
+        auto obtained_content = test_utils::read_file<CharT>(file);
+        std::fclose(file);
+
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, obtained_content.size());
+        TEST_EQ(status.count, half_str.size() + full_str.size());
+        TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                               , half_str.begin()
+                                               , half_str.size() ));
+        TEST_TRUE(0 == obtained_content.compare( half_str.size()
+                                               , full_str.size()
+                                               , full_str.begin()
+                                               , full_str.size() ));
+    }
+    {
+        std::FILE* file = std::tmpfile();
+        auto status = strf::to_mapped_file<CharT>(fileno(file))
+            .reserve_calc() (half_str, full_str);
+        std::rewind(file);
+        auto obtained_content = test_utils::read_file<CharT>(file);
+        std::fclose(file);
+
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, obtained_content.size());
+        TEST_EQ(status.count, half_str.size() + full_str.size());
+        TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                               , half_str.begin()
+                                               , half_str.size() ));
+        TEST_TRUE(0 == obtained_content.compare( half_str.size()
+                                               , full_str.size()
+                                               , full_str.begin()
+                                               , full_str.size() ));
+    }
+}
+
+static void test_overwriting_previous_content()
+{
+    std::FILE* file = std::tmpfile();
+    std::fputs("some previous content that is longer", file);
+    std::fflush(file);
+    auto status = strf::to_mapped_file(fileno(file)) ("Hello World");
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<char>(file);
+    std::fclose(file);
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, 11);
+    TEST_TRUE(obtained_content == "Hello World");
+}
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+static void test_space_is_reserved()
+{
+    // The file must not be sparse, otherwise a full disk would cause
+    // a SIGBUS when writing into the mapping
+    std::FILE* file = std::tmpfile();
+    strf::mapped_file_writer writer(fileno(file), 1 << 16);
+    struct stat st;
+    TEST_TRUE(0 == ::fstat(fileno(file), &st));
+    TEST_TRUE(st.st_size == (1 << 16));
+    TEST_TRUE(st.st_blocks * 512 >= st.st_size);
+
+    writer.recycle();
+    TEST_TRUE(0 == ::fstat(fileno(file), &st));
+    TEST_TRUE(st.st_size == (1 << 17));
+    TEST_TRUE(st.st_blocks * 512 >= st.st_size);
+
+    auto status = writer.finish();
+    std::fclose(file);
+    TEST_TRUE(status.success);
+}
+
+#endif // defined(__linux__) && defined(__GLIBC__)
+
+static void test_invalid_fd()
+{
+    auto status = strf::to_mapped_file(-1) ("Hello World");
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, 0);
+}
+
+void test_mapped_file_writer()
+{
+    test_destination<char>();
+    test_destination<char16_t>();
+    test_destination<char32_t>();
+    test_destination<wchar_t>();
+
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char16_t>();
+    test_writing_a_lot_after_turning_bad<char>();
+    test_writing_a_lot_after_turning_bad<char16_t>();
+
+    test_overwriting_previous_content();
+#if defined(__linux__) && defined(__GLIBC__)
+    test_space_is_reserved();
+#endif
+    test_invalid_fd();
+}
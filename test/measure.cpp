@@ -0,0 +1,85 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_string.hpp>
+#include "test_utils.hpp"
+
+static void test_size_and_width()
+{
+    {
+        auto r = strf::measure("abc", 123, strf::right(4.5, 10, '*'));
+        TEST_EQ(r.size, strf::to_string("abc", 123, strf::right(4.5, 10, '*')).size());
+        TEST_TRUE(r.width == 16);
+    }
+    {
+        auto r = strf::measure();
+        TEST_EQ(r.size, 0);
+        TEST_TRUE(r.width == 0);
+    }
+    {
+        // the width is not the size when there are multi-byte characters
+        auto r = strf::measure.with(strf::width_as_u32len{})
+            (strf::right("\xC3\xA1\xC3\xA9\xC3\xAD", 5, U'•'));
+        TEST_EQ(r.size, 2 * 3 + 2 * 3);
+        TEST_TRUE(r.width == 5);
+    }
+    {
+        auto r = strf::u16measure(strf::join_center(20, u'.')(u"abc", 1, 2, 3));
+        TEST_EQ(r.size, 20);
+        TEST_TRUE(r.width == 20);
+    }
+    {
+        // the width saturates
+        auto r = strf::measure(strf::right(0, 1000, '.'), strf::right(0, 32000, '.'));
+        TEST_EQ(r.size, 33000);
+        TEST_TRUE(r.width == strf::width_max);
+    }
+}
+
+static void test_size()
+{
+    TEST_EQ(strf::measure.size("abc", 123), 6);
+    TEST_EQ(strf::measure.size(strf::right(123, 100, '.')), 100);
+    TEST_EQ(strf::measure.size(strf::right(123, 100, U'•')), 3 + 97 * 3);
+    TEST_EQ(strf::u32measure.size(strf::right(123, 100, U'•')), 100);
+    TEST_EQ(strf::wmeasure.size(L"abc", strf::hex(255)), 5);
+    TEST_EQ(strf::measure.size(), 0);
+}
+
+static void test_tr()
+{
+    TEST_EQ(strf::measure.tr("{} + {} = {}", 1, 22, 23), 11);
+    TEST_EQ( strf::measure.tr("{}{{}}", strf::right("x", 10))
+           , strf::to_string.tr("{}{{}}", strf::right("x", 10)).size() );
+    TEST_EQ(strf::measure.tr(""), 0);
+    TEST_EQ(strf::u16measure.tr(u"{1}{0}{1}", u"ab", 12345), 12);
+
+    auto str = strf::to_string.tr("{} -- {} -- {}", "abc", strf::sci(1.5), strf::center(7, 9));
+    TEST_EQ( strf::measure.tr("{} -- {} -- {}", "abc", strf::sci(1.5), strf::center(7, 9))
+           , str.size() );
+}
+
+static void test_facets()
+{
+    strf::numpunct<10> punct{3};
+    auto measure = strf::measure.with(punct);
+    TEST_EQ(measure.size(1000000), 9);
+    TEST_EQ(measure(1000000).size, 9);
+    TEST_EQ(measure.tr("[{}]", 1000000), 11);
+    TEST_EQ(measure.with(strf::numpunct<10>{2}).size(1000000), 10);
+
+    // the facets are not copied into the original object
+    TEST_EQ(strf::measure.size(1000000), 7);
+
+    auto enc_measure = strf::measure.with(strf::iso_8859_1<char>());
+    TEST_EQ(enc_measure.size(strf::right(0, 10, U'á')), 10);
+}
+
+void test_measure()
+{
+    test_size_and_width();
+    test_size();
+    test_tr();
+    test_facets();
+}
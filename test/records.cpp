@@ -0,0 +1,98 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/records.hpp>
+#include <strf/to_string.hpp>
+#include <vector>
+#include <array>
+#include "test_utils.hpp"
+
+namespace {
+
+struct employee
+{
+    std::string name;
+    int id;
+    double salary;
+};
+
+} // unnamed namespace
+
+static void test_tuples()
+{
+    std::vector<std::tuple<const char*, char, int, char>> rows
+        { std::make_tuple("abc", '\t', 1, '\n')
+        , std::make_tuple("defg", '\t', 22, '\n')
+        , std::make_tuple("", '\t', 333, '\n') };
+
+    TEST("abc\t1\ndefg\t22\n\t333\n") (strf::records(rows));
+    TEST("abc\t1\ndefg\t22\n") (strf::records(rows.begin(), rows.begin() + 2));
+    TEST("") (strf::records(rows.begin(), rows.begin()));
+    TEST("__") ('_', strf::records(std::vector<std::tuple<int>>{}), '_');
+
+    std::pair<int, int> pairs[] = { {1, 2}, {3, 4}, {5, 6} };
+    TEST("123456") (strf::records(pairs));
+    TEST(u"123456") (strf::records(pairs));
+
+    std::array<int, 3> arrays[] = { {{1, 2, 3}}, {{4, 5, 6}} };
+    TEST("123456") (strf::records(arrays));
+}
+
+static void test_layout()
+{
+    std::vector<employee> staff
+        { {"Alice", 1, 1500.5}, {"Bob", 22, 1e+4}, {"Carol", 333, 0} };
+
+    auto layout = [](const employee& e) {
+        return std::make_tuple
+            ( strf::left(e.name, 6, '.'), strf::right(e.id, 4, '0')
+            , ',', strf::fixed(e.salary, 2), '\n' );
+    };
+    TEST( "Alice.0001,1500.50\n"
+          "Bob...0022,10000.00\n"
+          "Carol.0333,0.00\n" )
+        ( strf::records(staff, layout) );
+
+    // layout returning references
+    auto tie = [](const employee& e) { return std::tie(e.name, e.id); };
+    TEST("Alice1Bob22Carol333") (strf::records(staff, tie));
+    TEST("Alice1Bob22") (strf::records(staff.begin(), staff.begin() + 2, tie));
+
+    // facets apply to all records
+    TEST("10,000;20,000;")
+        .with(strf::numpunct<10>(3))
+        (strf::records({10000, 20000}, [](int x){ return std::make_tuple(x, ';'); }));
+}
+
+static void test_generator()
+{
+    auto gen = [](std::size_t i) { return std::make_tuple(i, ':', i * i, ' '); };
+    TEST("0:0 1:1 2:4 3:9 ") (strf::records(4, gen));
+    TEST("") (strf::records(0, gen));
+    TEST("[0][1][4]")
+        ( strf::records(3, gen, [](auto t){ return std::make_tuple('[', std::get<2>(t), ']'); }) );
+
+    // the size is calculated correctly
+    auto str = strf::to_string.reserve_calc() (strf::records(1000, gen));
+    std::string expected;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        expected += strf::to_string(i, ':', i * i, ' ');
+    }
+    TEST_TRUE(str == expected);
+}
+
+static void test_width()
+{
+    std::pair<int, int> pairs[] = { {1, 2}, {3, 4} };
+    TEST("....1234") (strf::join_right(8, '.')(strf::records(pairs)));
+    TEST("..1234..") (strf::join_center(8, '.')(strf::records(pairs)));
+}
+
+void test_records()
+{
+    test_tuples();
+    test_layout();
+    test_generator();
+    test_width();
+}
@@ -0,0 +1,184 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <strf/to_ring.hpp>
+#include <strf/to_string.hpp>
+#include "test_utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+static std::vector<std::string> drain_all(strf::ring& r)
+{
+    std::vector<std::string> records;
+    r.drain([&records](const char* str, std::size_t len) {
+                records.emplace_back(str, len);
+            });
+    return records;
+}
+
+static void test_single_producer()
+{
+    strf::ring r(16, 64);
+    const std::string big(150, 'x');
+    {
+        auto res = strf::to_ring(r) ("abc", 123);
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, 6);
+    }
+    {
+        // spans three slots
+        auto res = strf::to_ring(r) ('<', big, '>');
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, big.size() + 2);
+    }
+    strf::to_ring(r) ("def");
+
+    auto records = drain_all(r);
+    TEST_EQ(records.size(), 3);
+    TEST_TRUE(records[0] == "abc123");
+    TEST_TRUE(records[1] == '<' + big + '>');
+    TEST_TRUE(records[2] == "def");
+    TEST_EQ(r.dropped(), 0);
+
+    // slots are free again
+    TEST_EQ(drain_all(r).size(), 0);
+    for (int i = 0; i < 40; ++i) {
+        strf::to_ring(r) ("record ", i);
+        auto rec = drain_all(r);
+        TEST_EQ(rec.size(), 1);
+        TEST_TRUE(rec[0] == strf::to_string("record ", i));
+    }
+}
+
+static void test_interleaved_chains()
+{
+    strf::ring r(16, 64);
+    const std::string big_a(100, 'a');
+    const std::string big_b(100, 'b');
+    {
+        strf::ring_writer w1(r);
+        strf::ring_writer w2(r);
+        strf::to(w1) (big_a);
+        strf::to(w2) (big_b);
+        strf::to(w1) ("A");
+        strf::to(w2) ("B");
+        auto res2 = w2.finish();
+        auto res1 = w1.finish();
+        TEST_TRUE(res1.success);
+        TEST_TRUE(res2.success);
+    }
+    auto records = drain_all(r);
+    TEST_EQ(records.size(), 2);
+    // ordered by the position of the last slot of each record
+    TEST_TRUE(records[0] == big_a + "A");
+    TEST_TRUE(records[1] == big_b + "B");
+}
+
+static void test_full_ring()
+{
+    strf::ring r(4, 64);
+    const std::string big(300, 'x');
+    {
+        // needs five slots, so it is truncated at the fourth
+        auto res = strf::to_ring(r) (big);
+        TEST_TRUE(! res.success);
+        TEST_EQ(res.count, 4 * 64);
+    }
+    {
+        // no slot at all
+        auto res = strf::to_ring(r) ("abc");
+        TEST_TRUE(! res.success);
+        TEST_EQ(res.count, 0);
+    }
+    TEST_EQ(r.dropped(), 2);
+
+    auto records = drain_all(r);
+    TEST_EQ(records.size(), 1);
+    TEST_TRUE(records[0] == std::string(4 * 64, 'x'));
+
+    auto res = strf::to_ring(r) ("abc");
+    TEST_TRUE(res.success);
+    records = drain_all(r);
+    TEST_EQ(records.size(), 1);
+    TEST_TRUE(records[0] == "abc");
+}
+
+static void test_many_producers()
+{
+    constexpr int threads_count = 4;
+    constexpr int records_per_thread = 500;
+    strf::ring r(1 << 14, 64);
+
+    std::atomic<int> producers_running{threads_count};
+    std::vector<std::string> records;
+    std::thread consumer([&] {
+        for(;;) {
+            bool done = producers_running.load() == 0;
+            r.drain([&records](const char* str, std::size_t len) {
+                        records.emplace_back(str, len);
+                    });
+            if (done) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    });
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads_count; ++t) {
+        producers.emplace_back([&r, &producers_running, t] {
+            for (int i = 0; i < records_per_thread; ++i) {
+                strf::to_ring(r)
+                    ( t, ':', i, ':', strf::right("", i % 150, '.'), '\n' );
+            }
+            --producers_running;
+        });
+    }
+    for (auto& p: producers) {
+        p.join();
+    }
+    consumer.join();
+
+    TEST_EQ(r.dropped(), 0);
+    TEST_EQ(records.size(), threads_count * records_per_thread);
+    std::vector<std::string> expected;
+    for (int t = 0; t < threads_count; ++t) {
+        for (int i = 0; i < records_per_thread; ++i) {
+            expected.push_back
+                ( strf::to_string(t, ':', i, ':', strf::right("", i % 150, '.'), '\n') );
+        }
+    }
+    std::sort(records.begin(), records.end());
+    std::sort(expected.begin(), expected.end());
+    TEST_TRUE(records == expected);
+}
+
+static void test_drain_to_fd()
+{
+    strf::ring r(16, 64);
+    const std::string big(100, 'x');
+    strf::to_ring(r) ("abc\n");
+    strf::to_ring(r) (big, '\n');
+
+    std::FILE* file = std::tmpfile();
+    auto res = r.drain_to_fd(fileno(file));
+    std::rewind(file);
+    auto obtained = test_utils::read_file<char>(file);
+    std::fclose(file);
+
+    TEST_TRUE(res.success);
+    TEST_EQ(res.count, big.size() + 5);
+    TEST_TRUE(obtained == "abc\n" + big + '\n');
+}
+
+void test_ring_writer()
+{
+    test_single_producer();
+    test_interleaved_chains();
+    test_full_ring();
+    test_many_producers();
+    test_drain_to_fd();
+}
@@ -0,0 +1,104 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_scratch.hpp>
+#include "test_utils.hpp"
+
+template <typename CharT>
+static std::basic_string<CharT> to_std_string(const typename strf::basic_scratch_writer<CharT>::result& r)
+{
+    return {r.data(), r.size()};
+}
+
+template <typename CharT>
+static void test_successfull_writing()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    std::basic_string<CharT> expected;
+
+    strf::basic_scratch_writer<CharT> writer;
+    for (int i = 0; i < 10; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+        expected.append(double_str.begin(), double_str.size());
+    }
+    auto result = writer.finish();
+
+    TEST_EQ(result.size(), expected.size());
+    TEST_TRUE(to_std_string<CharT>(result) == expected);
+}
+
+template <typename CharT>
+static void test_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto full_str = test_utils::make_full_string<CharT>();
+    std::basic_string<CharT> expected(half_str.begin(), half_str.size());
+    expected.append(full_str.begin(), full_str.size());
+    {
+        auto result = strf::to_basic_scratch<CharT> (half_str, full_str);
+        TEST_TRUE(to_std_string<CharT>(result) == expected);
+    }
+    {
+        auto result = strf::to_basic_scratch<CharT>.reserve_calc() (half_str, full_str);
+        TEST_TRUE(to_std_string<CharT>(result) == expected);
+    }
+}
+
+static void test_buffer_is_reused()
+{
+    auto r1 = strf::to_scratch ("Hello ", 1);
+    TEST_TRUE(to_std_string<char>(r1) == "Hello 1");
+    const char* first_data = r1.data();
+
+    auto r2 = strf::to_scratch ("Hello ", 2);
+    TEST_TRUE(to_std_string<char>(r2) == "Hello 2");
+    TEST_TRUE(r2.data() == first_data);
+
+    // grows when needed
+    auto r3 = strf::to_scratch (strf::right("x", 5000, '.'));
+    TEST_TRUE(to_std_string<char>(r3) == std::string(4999, '.') + "x");
+
+    // and then keeps the larger buffer
+    const char* large_data = r3.data();
+    auto r4 = strf::to_scratch (strf::right("y", 4000, '.'));
+    TEST_TRUE(to_std_string<char>(r4) == std::string(3999, '.') + "y");
+    TEST_TRUE(r4.data() == large_data);
+
+    // each character type has its own buffer
+    auto r5 = strf::to_u16scratch (u"abc");
+    auto r6 = strf::to_scratch ("def");
+    TEST_TRUE(to_std_string<char16_t>(r5) == u"abc");
+    TEST_TRUE(to_std_string<char>(r6) == "def");
+}
+
+template <typename CharT>
+static void test_make_after_turning_bad()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    strf::basic_scratch_writer<CharT> writer;
+    write(writer, half_str.begin(), half_str.size());
+    test_utils::turn_into_bad(writer);
+    writer.recycle();
+    write(writer, double_str.begin(), double_str.size());
+    auto result = writer.finish();
+
+    TEST_TRUE(to_std_string<CharT>(result) == std::basic_string<CharT>(half_str.begin(), half_str.size()));
+}
+
+void test_scratch_writer()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+
+    test_destination<char>();
+    test_destination<wchar_t>();
+
+    test_make_after_turning_bad<char>();
+    test_make_after_turning_bad<char16_t>();
+
+    test_buffer_is_reused();
+}
@@ -4,6 +4,7 @@
 
 #include <strf/to_streambuf.hpp>
 #include "test_utils.hpp"
+#include "streambuf_that_fails_on_overflow.hpp"
 #include <sstream>
 
 template <typename CharT>
@@ -120,6 +121,159 @@ static void test_destination()
     }
 }
 
+template <typename CharT>
+static void test_destination_with_buffer()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    CharT buff[test_utils::full_string_size<CharT>];
+    {
+        std::basic_ostringstream<CharT> dest;
+        auto status = strf::to(*dest.rdbuf(), buff) (double_str, double_str);
+        auto obtained_content = dest.str();
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, 2 * double_str.size());
+        TEST_EQ(obtained_content.size(), 2 * double_str.size());
+        TEST_TRUE(0 == obtained_content.compare( 0, double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+        TEST_TRUE(0 == obtained_content.compare( double_str.size()
+                                               , double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+    }
+    {
+        std::basic_ostringstream<CharT> dest;
+        auto status = strf::to(dest.rdbuf(), buff, test_utils::full_string_size<CharT>)
+            (double_str, double_str);
+        auto obtained_content = dest.str();
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, 2 * double_str.size());
+        TEST_EQ(obtained_content.size(), 2 * double_str.size());
+        TEST_TRUE(0 == obtained_content.compare( double_str.size()
+                                               , double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+    }
+}
+
+// Keeps a fixed put area, and only appends its content to
+// a string when sync() or overflow() is called.
+template <typename CharT>
+class syncing_streambuf: public std::basic_streambuf<CharT>
+{
+    using base_ = std::basic_streambuf<CharT>;
+
+public:
+
+    using int_type = typename base_::int_type;
+
+    syncing_streambuf()
+    {
+        base_::setp(buffer_, buffer_ + buffer_size_);
+    }
+
+    std::basic_string<CharT> str()
+    {
+        sync();
+        return str_;
+    }
+
+    int sync_count = 0;
+
+protected:
+
+    int sync() override
+    {
+        ++ sync_count;
+        str_.append(base_::pbase(), base_::pptr());
+        base_::setp(buffer_, buffer_ + buffer_size_);
+        return 0;
+    }
+
+    int_type overflow(int_type ch) override
+    {
+        sync();
+        if ( ! std::char_traits<CharT>::eq_int_type(ch, std::char_traits<CharT>::eof())) {
+            base_::sputc(std::char_traits<CharT>::to_char_type(ch));
+        }
+        return std::char_traits<CharT>::not_eof(ch);
+    }
+
+private:
+
+    std::basic_string<CharT> str_;
+    static constexpr std::size_t buffer_size_ = 200;
+    CharT buffer_[buffer_size_];
+};
+
+template <typename CharT>
+static void test_direct_writer_on_stringbuf()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    constexpr std::size_t count = 50;
+
+    std::basic_ostringstream<CharT> dest;
+    strf::basic_streambuf_direct_writer<CharT> writer(dest.rdbuf());
+    for (std::size_t i = 0; i < count; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+    }
+    auto status = writer.finish();
+    auto obtained_content = dest.str();
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, count * double_str.size());
+    TEST_EQ(obtained_content.size(), count * double_str.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        TEST_TRUE(0 == obtained_content.compare( i * double_str.size()
+                                               , double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+    }
+}
+
+template <typename CharT>
+static void test_direct_writer_syncing()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    constexpr std::size_t count = 10;
+
+    syncing_streambuf<CharT> dest;
+    auto status = strf::to_put_area(dest)
+        ( double_str, double_str, double_str, double_str, double_str
+        , double_str, double_str, double_str, double_str, double_str );
+    auto obtained_content = dest.str();
+
+    TEST_TRUE(status.success);
+    TEST_TRUE(dest.sync_count > 1);
+    TEST_EQ(status.count, count * double_str.size());
+    TEST_EQ(obtained_content.size(), count * double_str.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        TEST_TRUE(0 == obtained_content.compare( i * double_str.size()
+                                               , double_str.size()
+                                               , double_str.begin()
+                                               , double_str.size() ));
+    }
+}
+
+template <typename CharT>
+static void test_direct_writer_failing()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+    constexpr std::size_t capacity = test_utils::full_string_size<CharT> * 2 + 10;
+
+    streambuf_that_fails_on_overflow<capacity, CharT> dest;
+    auto status = strf::to_put_area(dest) (double_str, half_str, half_str);
+    auto obtained_content = dest.str();
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(static_cast<std::size_t>(status.count), obtained_content.size());
+    TEST_TRUE(obtained_content.size() >= double_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+}
+
 void test_streambuf_writer()
 {
     test_destination<char>();
@@ -127,6 +281,9 @@ void test_streambuf_writer()
     test_destination<char32_t>();
     test_destination<wchar_t>();
 
+    test_destination_with_buffer<char>();
+    test_destination_with_buffer<char16_t>();
+
     test_successfull_writing<char>();
     test_successfull_writing<char16_t>();
     test_successfull_writing<char32_t>();
@@ -141,4 +298,14 @@ void test_streambuf_writer()
     test_failing_to_finish<char16_t>();
     test_failing_to_finish<char32_t>();
     test_failing_to_finish<wchar_t>();
+
+    test_direct_writer_on_stringbuf<char>();
+    test_direct_writer_on_stringbuf<char16_t>();
+    test_direct_writer_on_stringbuf<wchar_t>();
+
+    test_direct_writer_syncing<char>();
+    test_direct_writer_syncing<char32_t>();
+
+    test_direct_writer_failing<char>();
+    test_direct_writer_failing<char16_t>();
 }
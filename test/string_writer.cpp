@@ -4,6 +4,7 @@
 
 #include "test_utils.hpp"
 #include <strf/to_string.hpp>
+#include <thread>
 
 template <typename CharT>
 static void test_successfull_append()
@@ -48,6 +49,114 @@ static void test_successfull_make()
                                  , double_str.size() ));
 }
 
+template <typename CharT>
+static void test_make_large_string()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    constexpr std::size_t count = 100;
+
+    strf::basic_string_maker<CharT> ob;
+    for (std::size_t i = 0; i < count; ++i) {
+        write(ob, double_str.begin(), double_str.size());
+        strf::put<CharT>(ob, static_cast<CharT>('\n'));
+    }
+    auto result = ob.finish();
+
+    TEST_EQ(result.size(), count * (double_str.size() + 1));
+    for (std::size_t i = 0; i < count; ++i) {
+        auto pos = i * (double_str.size() + 1);
+        TEST_TRUE(0 == result.compare( pos, double_str.size()
+                                     , double_str.begin()
+                                     , double_str.size() ));
+        TEST_TRUE(result[pos + double_str.size()] == static_cast<CharT>('\n'));
+    }
+}
+
+template <typename CharT>
+static void test_sized_make_with_zero_size()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    {
+        strf::basic_sized_string_maker<CharT> ob(0);
+        auto result = ob.finish();
+        TEST_TRUE(result.empty());
+    }
+    {
+        strf::basic_sized_string_maker<CharT> ob(0);
+        write(ob, double_str.begin(), double_str.size());
+        auto result = ob.finish();
+        TEST_TRUE(result == std::basic_string<CharT>(double_str.begin(), double_str.size()));
+    }
+    {
+        auto result = strf::to_basic_string<CharT>.reserve(0) (double_str);
+        TEST_TRUE(result == std::basic_string<CharT>(double_str.begin(), double_str.size()));
+    }
+}
+
+template <typename CharT>
+static void test_make_after_turning_bad()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    strf::basic_string_maker<CharT> ob;
+    write(ob, half_str.begin(), half_str.size());
+    test_utils::turn_into_bad(ob);
+    ob.recycle();
+    write(ob, double_str.begin(), double_str.size());
+    auto result = ob.finish();
+
+    TEST_EQ(result.size(), half_str.size());
+    TEST_TRUE(0 == result.compare( 0, half_str.size()
+                                 , half_str.begin()
+                                 , half_str.size() ));
+}
+
+static void test_finish_in_another_thread()
+{
+    // The writer must not find out that it is no longer writing into
+    // its string by comparing end() with the garbage buffer, since the
+    // one of the thread where it turned bad is gone
+    auto half_str = test_utils::make_half_string<char>();
+    auto double_str = test_utils::make_double_string<char>();
+
+    strf::string_maker ob;
+    std::thread t{ [&]() {
+        write(ob, half_str.begin(), half_str.size());
+        test_utils::turn_into_bad(ob);
+        ob.recycle();
+        write(ob, double_str.begin(), double_str.size());
+    } };
+    t.join();
+    auto result = ob.finish();
+
+    TEST_EQ(result.size(), half_str.size());
+    TEST_TRUE(0 == result.compare( 0, half_str.size()
+                                 , half_str.begin()
+                                 , half_str.size() ));
+}
+
+template <typename CharT>
+static void test_external_buffer()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+    CharT buff[test_utils::full_string_size<CharT>];
+    {
+        std::basic_string<CharT> str;
+        strf::basic_string_appender<CharT> ob(str, buff, test_utils::full_string_size<CharT>);
+        write(ob, tiny_str.begin(), tiny_str.size());
+        write(ob, double_str.begin(), double_str.size());
+        ob.finish();
+
+        TEST_EQ(str.size(), tiny_str.size() + double_str.size());
+        TEST_TRUE(0 == str.compare( tiny_str.size()
+                                  , double_str.size()
+                                  , double_str.begin()
+                                  , double_str.size() ));
+    }
+}
+
 template <typename CharT>
 static void test_destinations()
 {
@@ -124,4 +233,18 @@ void test_string_writer()
     test_successfull_make<char16_t>();
     test_successfull_make<char>();
     test_successfull_make<char16_t>();
+
+    test_make_large_string<char>();
+    test_make_large_string<char16_t>();
+    test_make_large_string<char32_t>();
+
+    test_sized_make_with_zero_size<char>();
+    test_sized_make_with_zero_size<char32_t>();
+
+    test_make_after_turning_bad<char>();
+    test_make_after_turning_bad<char16_t>();
+    test_finish_in_another_thread();
+
+    test_external_buffer<char>();
+    test_external_buffer<char16_t>();
 }
@@ -0,0 +1,161 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/to_tee.hpp>
+#include <strf/to_string.hpp>
+#include "test_utils.hpp"
+
+namespace {
+
+struct counted_printable
+{
+    int* count;
+};
+
+template <typename CharT>
+class counted_printer: public strf::printer<CharT>
+{
+public:
+
+    template <typename... T>
+    counted_printer(strf::usual_printer_input<T...> input)
+        : count_(input.arg.count)
+    {
+        input.preview.add_size(1);
+        input.preview.subtract_width(1);
+    }
+
+    void print_to(strf::basic_outbuff<CharT>& ob) const override
+    {
+        ++*count_;
+        strf::put(ob, static_cast<CharT>('#'));
+    }
+
+private:
+
+    int* count_;
+};
+
+} // unnamed namespace
+
+namespace strf {
+
+template <>
+struct print_traits<counted_printable> {
+    using facet_tag = void;
+    using forwarded_type = counted_printable;
+
+    template <typename CharT, typename Preview, typename FPack>
+    static auto make_printer_input(Preview& preview, const FPack& fp, counted_printable x)
+        -> strf::usual_printer_input
+            < CharT, Preview, FPack, counted_printable, counted_printer<CharT> >
+    {
+        return {preview, fp, x};
+    }
+};
+
+} // namespace strf
+
+template <typename CharT>
+static void test_successfull_writing()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+
+    strf::basic_string_maker<CharT> dest1;
+    strf::basic_string_maker<CharT> dest2;
+    strf::basic_string_maker<CharT> dest3;
+
+    strf::basic_tee_writer<CharT, 3> tee(dest1, dest2, dest3);
+    write(tee, double_str.begin(), double_str.size());
+    write(tee, half_str.begin(), half_str.size());
+    tee.finish();
+    TEST_TRUE(! tee.good());
+
+    std::basic_string<CharT> expected(double_str.begin(), double_str.end());
+    expected.append(half_str.begin(), half_str.end());
+
+    TEST_TRUE(dest1.finish() == expected);
+    TEST_TRUE(dest2.finish() == expected);
+    TEST_TRUE(dest3.finish() == expected);
+}
+
+static void test_destination()
+{
+    int count = 0;
+    strf::string_maker dest1;
+    strf::string_maker dest2;
+    strf::to_tee(dest1, dest2) ("abc", counted_printable{&count}, strf::right(1, 1000, '.'));
+
+    auto expected = strf::to_string("abc#", strf::right(1, 1000, '.'));
+    TEST_EQ(count, 1);
+    TEST_TRUE(dest1.finish() == expected);
+    TEST_TRUE(dest2.finish() == expected);
+}
+
+static void test_bad_downstream()
+{
+    char small_buff[10];
+    strf::cstr_writer dest1(small_buff);
+    strf::string_maker dest2;
+    {
+        strf::tee_writer<2> tee(dest1, dest2);
+        strf::to(tee) (strf::right("abc", 1000, '.'));
+        tee.recycle();
+        TEST_TRUE(! dest1.good());
+        TEST_TRUE(tee.good());
+        strf::to(tee) ("xyz");
+        tee.finish();
+    }
+    auto r1 = dest1.finish();
+    TEST_TRUE(r1.truncated);
+    TEST_CSTR_EQ(small_buff, ".........");
+    TEST_TRUE(dest2.finish() == strf::to_string(strf::right("abc", 1000, '.'), "xyz"));
+}
+
+static void test_all_downstream_bad()
+{
+    char buff1[10];
+    char buff2[20];
+    strf::cstr_writer dest1(buff1);
+    strf::cstr_writer dest2(buff2);
+    strf::tee_writer<2> tee(dest1, dest2);
+
+    strf::to(tee) (strf::right("abc", 1000, '.'));
+    tee.recycle();
+    TEST_TRUE(! tee.good());
+    TEST_TRUE(tee.pointer() == strf::outbuff_garbage_buf<char>());
+    tee.finish();
+    TEST_TRUE(dest1.finish().truncated);
+    TEST_TRUE(dest2.finish().truncated);
+}
+
+static void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<char>();
+    auto double_str = test_utils::make_double_string<char>();
+
+    strf::string_maker dest;
+    strf::tee_writer<1> tee(dest);
+    write(tee, half_str.begin(), half_str.size());
+    tee.recycle();
+    test_utils::turn_into_bad(tee);
+    write(tee, double_str.begin(), double_str.size());
+    tee.finish();
+
+    auto obtained = dest.finish();
+    TEST_TRUE(obtained == std::string(half_str.begin(), half_str.end()));
+}
+
+void test_tee_writer()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+    test_destination();
+    test_bad_downstream();
+    test_all_downstream_bad();
+    test_failing_to_recycle();
+}
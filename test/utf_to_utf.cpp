@@ -3,9 +3,11 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include "test_utils.hpp"
+#include <strf/to_string.hpp>
 
 #include <array>
 #include <tuple>
+#include <algorithm>
 
 template <typename T>
 constexpr STRF_TEST_FUNC auto as_signed(const T& value)
@@ -277,6 +279,167 @@ void STRF_TEST_FUNC test_invalid_input(SrcEncoding src_enc, DestEncoding dest_en
 }
 
 
+#if ! defined(__CUDACC__)
+
+// Long inputs with ASCII runs of several lengths between non-ASCII
+// characters, followed by runs of two and three bytes UTF-8 sequences,
+// to cover the block-wise code paths of the transcoders.
+template <typename CharT>
+std::basic_string<CharT> long_sample()
+{
+    const char32_t non_ascii[] = { 0xE1, 0x800, 0xFFFD, 0x10000, 0x10FFFF, 0x7FF };
+    std::u32string u32str;
+    for (unsigned i = 0; i < 70; ++i) {
+        for (unsigned j = 0; j < i; ++j) {
+            u32str.push_back(static_cast<char32_t>(0x20 + (i + j) % 0x5F));
+        }
+        u32str.push_back(non_ascii[i % 6]);
+    }
+    for (unsigned i = 0; i < 40; ++i) {
+        for (unsigned j = 0; j < i; ++j) {
+            const char32_t ascii = 0x20 + j % 0x5F;
+            const char32_t two_bytes = 0x80 + (j * 37) % 0x780;
+            const char32_t three_bytes = (j & 1)
+                ? 0xE000 + (j * 97) % 0x2000
+                : 0x800 + (j * 997) % (0xD800 - 0x800);
+            const char32_t from_cases[] =
+                { two_bytes
+                , three_bytes
+                , (j % 3 == 0) ? ascii : two_bytes
+                , (j & 1) ? two_bytes : three_bytes };
+            u32str.push_back(from_cases[i % 4]);
+        }
+        u32str.push_back(non_ascii[i % 6]);
+    }
+    u32str.append(100, U'x');
+    return strf::to_basic_string<CharT>(strf::conv(u32str));
+}
+
+template <typename SrcEncoding, typename DestEncoding>
+void test_long_input(SrcEncoding src_enc, DestEncoding dest_enc)
+{
+    TEST_SCOPE_DESCRIPTION("long input from ", src_enc.name(), " to ", dest_enc.name());
+    using src_char_type  = get_first_template_parameter<SrcEncoding>;
+    using dest_char_type = get_first_template_parameter<DestEncoding>;
+
+    const auto input = long_sample<src_char_type>();
+    const auto expected = long_sample<dest_char_type>();
+
+    TEST_EQ( strf::basic_measure<dest_char_type>.with(dest_enc).size(strf::sani(input, src_enc))
+           , expected.size() );
+    {
+        auto result = strf::to_basic_string<dest_char_type>
+            .with(dest_enc) (strf::sani(input, src_enc));
+        TEST_TRUE(result == expected);
+    }
+    {   // destination too small
+        dest_char_type buff[101];
+        auto res = strf::to(buff).with(dest_enc) (strf::sani(input, src_enc));
+        TEST_TRUE(res.truncated);
+        TEST_TRUE(res.ptr - buff <= 100);
+        TEST_TRUE(std::equal(buff, res.ptr, expected.begin()));
+    }
+    for (std::size_t buff_size = 2700; buff_size < 2704; ++buff_size) {
+        // destination too small
+        std::basic_string<dest_char_type> buff(buff_size, '\0');
+        auto res = strf::to(&buff[0], buff_size).with(dest_enc) (strf::sani(input, src_enc));
+        TEST_TRUE(res.truncated);
+        TEST_TRUE(res.ptr - &buff[0] < static_cast<std::ptrdiff_t>(buff_size));
+        TEST_TRUE(std::equal(&buff[0], res.ptr, expected.begin()));
+
+        // the last character is not split
+        const std::basic_string<dest_char_type> truncated(&buff[0], res.ptr);
+        auto sanitized = strf::to_basic_string<dest_char_type>
+            .with(dest_enc) (strf::sani(truncated, dest_enc));
+        TEST_TRUE(sanitized == truncated);
+    }
+    {   // an invalid sequence in the middle of an ASCII run
+        auto invalid_input = input;
+        invalid_input.insert(500, 1, static_cast<src_char_type>(0xDFFF));
+        invalid_input.insert(40, 1, static_cast<src_char_type>(0xDFFF));
+        auto r1 = strf::to_basic_string<dest_char_type>
+            .with(dest_enc) (strf::sani(invalid_input.substr(0, 500), src_enc));
+        auto r2 = strf::to_basic_string<dest_char_type>
+            .with(dest_enc) (strf::sani(invalid_input, src_enc));
+        TEST_TRUE(r2.size() > r1.size());
+        TEST_TRUE(std::equal(r1.begin(), r1.end(), r2.begin()));
+        TEST_TRUE(r2.size() < expected.size() + 30);
+    }
+}
+
+
+// Invalid and truncated UTF-8 sequences starting at every position of
+// a 16 bytes block, so that they cross the boundaries of the blocks
+// that the vectorized validator checks.
+template <typename DestEncoding>
+void test_invalid_utf8_across_blocks(DestEncoding dest_enc)
+{
+    TEST_SCOPE_DESCRIPTION("invalid UTF-8 across blocks to ", dest_enc.name());
+    using dest_char_type = get_first_template_parameter<DestEncoding>;
+
+    const std::basic_string<dest_char_type> replacement
+        = strf::to_basic_string<dest_char_type>.with(dest_enc) (replacement_char(dest_enc));
+
+    for (const auto& s : invalid_sequences(strf::utf<char>())) {
+        const std::string seq(s.sequence.begin(), s.sequence.end());
+        for (std::size_t prefix_size = 0; prefix_size < 40; ++prefix_size) {
+            for (std::size_t suffix_size : {0, 1, 40}) {
+                TEST_SCOPE_DESCRIPTION
+                    ( "Sequence = ", strf::separated_range(seq, " ", [](char ch)
+                          { return *strf::hex((unsigned)(unsigned char)ch); } )
+                    , ", prefix size = ", prefix_size, ", suffix size = ", suffix_size);
+
+                std::string input;
+                std::basic_string<dest_char_type> expected;
+                for (std::size_t i = 0; i < prefix_size; ++i) {
+                    input.push_back(static_cast<char>('a' + i % 26));
+                    expected.push_back(static_cast<dest_char_type>('a' + i % 26));
+                }
+                input += seq;
+                for (int i = 0; i < s.errors_count; ++i) {
+                    expected += replacement;
+                }
+                input.append(suffix_size, 'x');
+                expected.append(suffix_size, static_cast<dest_char_type>('x'));
+
+                auto result = strf::to_basic_string<dest_char_type>
+                    .with(dest_enc) (strf::sani(input, strf::utf<char>()));
+                TEST_TRUE(result == expected);
+                TEST_EQ( strf::basic_measure<dest_char_type>.with(dest_enc)
+                             .size(strf::sani(input, strf::utf<char>()))
+                       , expected.size() );
+            }
+        }
+    }
+    {   // a surrogate starting at the last byte of a block
+        std::string input(15, 'a');
+        input += "\xED\xA0\x80";
+        input.append(20, 'b');
+        std::u32string u32input(15, U'a');
+        u32input.push_back(0xD800);
+        u32input.append(20, U'b');
+
+        auto expected_lax = strf::to_basic_string<dest_char_type>
+            .with(dest_enc, strf::surrogate_policy::lax)
+            (strf::sani(u32input, strf::utf<char32_t>()));
+        auto result_lax = strf::to_basic_string<dest_char_type>
+            .with(dest_enc, strf::surrogate_policy::lax)
+            (strf::sani(input, strf::utf<char>()));
+        TEST_TRUE(result_lax == expected_lax);
+
+        std::basic_string<dest_char_type> expected(15, static_cast<dest_char_type>('a'));
+        expected += replacement;
+        expected += replacement;
+        expected += replacement;
+        expected.append(20, static_cast<dest_char_type>('b'));
+        auto result = strf::to_basic_string<dest_char_type>
+            .with(dest_enc) (strf::sani(input, strf::utf<char>()));
+        TEST_TRUE(result == expected);
+    }
+}
+
+#endif // ! defined(__CUDACC__)
+
 template < typename Func
          , typename SrcEncoding >
 void STRF_TEST_FUNC combine_3(Func, SrcEncoding)
@@ -367,6 +530,17 @@ void STRF_TEST_FUNC test_utf_to_utf()
         ( encodings
         , [](auto src_enc, auto dest_enc){ test_invalid_input(src_enc, dest_enc); } );
 
+#if ! defined(__CUDACC__)
+    for_all_combinations
+        ( encodings
+        , [](auto src_enc, auto dest_enc){ test_long_input(src_enc, dest_enc); } );
+
+    test_invalid_utf8_across_blocks(strf::utf<char>());
+    test_invalid_utf8_across_blocks(strf::utf<char16_t>());
+    test_invalid_utf8_across_blocks(strf::utf<char32_t>());
+    test_invalid_utf8_across_blocks(strf::utf<wchar_t>());
+#endif
+
     TEST_TRUE((std::is_same
                    < strf::static_transcoder
                        < char, char, strf::eid_utf8, strf::eid_utf8 >
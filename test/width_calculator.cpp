@@ -3,11 +3,84 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include "test_utils.hpp"
+#include <strf/to_string.hpp>
+#include <vector>
 
 #define TEST_FAST_WIDTH(STR) TEST(STR) .with( strf::fast_width{} )
 #define TEST_W_AS_FAST_U32LEN(STR) TEST(STR) .with( strf::width_as_fast_u32len{} )
 #define TEST_W_AS_U32LEN(STR) TEST(STR) .with( strf::width_as_u32len{} )
 
+#if ! defined(__CUDACC__)
+
+template <typename CharT>
+std::vector<std::basic_string<CharT>> invalid_sequences_samples();
+
+template <>
+std::vector<std::string> invalid_sequences_samples<char>()
+{
+    return {"\xFF", "\xC2", "\xE1\x80", "\xC0", "\xF4\x8F\xBF"};
+}
+
+template <>
+std::vector<std::u16string> invalid_sequences_samples<char16_t>()
+{
+    return {std::u16string(1, 0xD800), std::u16string(1, 0xDFFF)};
+}
+
+template <>
+std::vector<std::u32string> invalid_sequences_samples<char32_t>()
+{
+    return {std::u32string(1, 0x110000)};
+}
+
+// Counts the code points of long inputs with every possible max_count,
+// to cover the block-wise code paths of codepoints_fast_count and
+// codepoints_robust_count. The input is made of pieces that are one code
+// point each, and that are invalid sequences in the second round.
+template <typename CharT>
+void test_long_input_codepoints_count()
+{
+    const char32_t non_ascii[] = { 0xE1, 0x800, 0xFFFD, 0x10000, 0x10FFFF, 0x7FF };
+    const auto invalid = invalid_sequences_samples<CharT>();
+    const auto enc = strf::utf<CharT>();
+    for (int round = 0; round < 2; ++round) {
+        TEST_SCOPE_DESCRIPTION( "long input with ", enc.name()
+                              , round ? " and invalid sequences" : "" );
+        std::basic_string<CharT> input;
+        std::vector<std::size_t> offsets = {0};
+        for (unsigned i = 0; i < 60; ++i) {
+            for (unsigned j = 0; j < i; ++j) {
+                const char32_t ch = (i % 3 == 0) ? 0x20 + (i + j) % 0x5F
+                                  : (i % 3 == 1) ? non_ascii[j % 6]
+                                  : 0x800 + (j * 997) % (0xD800 - 0x800);
+                input += strf::to_basic_string<CharT>(strf::conv(std::u32string(1, ch)));
+                offsets.push_back(input.size());
+            }
+            if (round == 1) {
+                input += invalid[i % invalid.size()];
+            } else {
+                input += strf::to_basic_string<CharT>(strf::conv(std::u32string(1, non_ascii[i % 6])));
+            }
+            offsets.push_back(input.size());
+        }
+        const auto total = offsets.size() - 1;
+        for (std::size_t max_count = 0; max_count <= total + 1; ++max_count) {
+            const auto expected_count = max_count < total ? max_count : total;
+            if (round == 0) {
+                auto r = enc.codepoints_fast_count(input.data(), input.size(), max_count);
+                TEST_EQ(r.count, expected_count);
+                TEST_EQ(r.pos, offsets[expected_count]);
+            }
+            auto r = enc.codepoints_robust_count
+                ( input.data(), input.size(), max_count, strf::surrogate_policy::strict );
+            TEST_EQ(r.count, expected_count);
+            TEST_EQ(r.pos, offsets[expected_count]);
+        }
+    }
+}
+
+#endif // ! defined(__CUDACC__)
+
 void STRF_TEST_FUNC test_width_calculator()
 {
     using namespace strf::width_literal;
@@ -256,5 +329,15 @@ void STRF_TEST_FUNC test_width_calculator()
         TEST_W_AS_U32LEN(str_0xDFFF)        (strf::right(str_0xDFFF + 1, 4));
         TEST_W_AS_U32LEN(str_0xDFFF_0xD800) (strf::right(str_0xDFFF_0xD800 + 1, 6));
 
+        // A valid surrogate pair is one code point
+        TEST_W_AS_U32LEN(u"  \U00010000\U0010FFFF") (strf::right(u"\U00010000\U0010FFFF", 4));
     }
+
+#if ! defined(__CUDACC__)
+
+    test_long_input_codepoints_count<char>();
+    test_long_input_codepoints_count<char16_t>();
+    test_long_input_codepoints_count<char32_t>();
+
+#endif // ! defined(__CUDACC__)
 }